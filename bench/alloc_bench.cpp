@@ -0,0 +1,92 @@
+// Allocator throughput benchmark: malloc/free rate, peak RSS and final
+// fragmentation under an allocation-heavy random workload.
+//
+// Usage: alloc_bench [live_blocks] [operations] [first|best|worst|buddy|slab]
+#include "../include/BuddyAllocator.h"
+#include "../include/MemoryManager.h"
+#include "../include/SlabAllocator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+static long peak_rss_kb() {
+#if !defined(_WIN32)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // KB on Linux
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    int live_target = (argc > 1) ? std::atoi(argv[1]) : 200000;
+    long long operations = (argc > 2) ? std::atoll(argv[2]) : 2000000;
+    std::string strategy = (argc > 3) ? argv[3] : "first";
+
+    const int min_size = 16, max_size = 512;
+    long long heap_size = (long long)live_target * max_size; // Room to spare at average size
+
+    Allocator* allocator;
+    if (strategy == "buddy") {
+        allocator = new BuddyAllocator(heap_size);
+    } else if (strategy == "slab") {
+        allocator = new SlabAllocator(heap_size);
+    } else {
+        MemorySimulator* list_mem = new MemorySimulator(heap_size);
+        if (strategy == "best") list_mem->set_strategy(BEST_FIT);
+        else if (strategy == "worst") list_mem->set_strategy(WORST_FIT);
+        allocator = list_mem;
+    }
+    Allocator& mem = *allocator;
+    mem.set_verbose(false);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> size_dist(min_size, max_size);
+    std::vector<long long> live;
+    live.reserve(live_target);
+
+    // Warm up: build a heap with live_target blocks
+    for (int i = 0; i < live_target; i++) {
+        long long addr = mem.my_malloc(size_dist(rng));
+        if (addr >= 0) live.push_back(addr);
+    }
+
+    // Steady state: random frees and mallocs around the target size
+    auto start = std::chrono::steady_clock::now();
+    long long mallocs = 0, frees = 0;
+    for (long long op = 0; op < operations; op++) {
+        if (!live.empty() && (live.size() >= (size_t)live_target || (rng() & 1))) {
+            size_t i = rng() % live.size();
+            mem.my_free(live[i]);
+            live[i] = live.back();
+            live.pop_back();
+            frees++;
+        } else {
+            long long addr = mem.my_malloc(size_dist(rng));
+            if (addr >= 0) live.push_back(addr);
+            mallocs++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Strategy:        " << strategy << "\n";
+    std::cout << "Live Blocks:     " << live_target << "\n";
+    std::cout << "Operations:      " << operations << " (" << mallocs << " malloc, "
+              << frees << " free)\n";
+    std::cout << "Elapsed:         " << seconds << " s\n";
+    std::cout << "Throughput:      " << (long long)(operations / seconds) << " ops/s\n";
+    std::cout << "Peak RSS:        " << peak_rss_kb() << " KB\n";
+    mem.print_stats();
+
+    delete allocator;
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Page-fault benchmark: fault-handling rate and fault count of a page
+// replacement policy with a large resident set under memory pressure.
+//
+// Usage: page_bench [resident_pages] [accesses] [lru|clock|enhanced-clock] [page_size]
+#include "../include/BuddyAllocator.h"
+#include "../include/VirtualMemory.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+static long peak_rss_kb() {
+#if !defined(_WIN32)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // KB on Linux
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char* argv[]) {
+    long long resident = (argc > 1) ? std::atoll(argv[1]) : 1 << 20;
+    long long accesses = (argc > 2) ? std::atoll(argv[2]) : 4000000;
+    std::string policy = (argc > 3) ? argv[3] : "lru";
+    long long page_size = (argc > 4) ? std::atoll(argv[4]) : 4096;
+
+    PageReplacer* replacer = create_page_replacer(policy);
+    if (!replacer) return 1;
+
+    // Physical memory holds exactly `resident` frames
+    BuddyAllocator memory(resident * page_size, page_size);
+    memory.set_verbose(false);
+    MMU mmu(page_size, nullptr, &memory);
+    mmu.set_page_replacer(replacer);
+    mmu.set_verbose(false);
+
+    // Fill memory, then run a skewed workload over twice the resident set:
+    // 90% of accesses hit a hot half of it, the rest are spread uniformly.
+    for (long long vpn = 0; vpn < resident; vpn++) mmu.access(vpn * page_size, vpn % 4 == 0);
+    long long warm_faults = mmu.get_page_faults();
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long long> hot(0, resident / 2 - 1);
+    std::uniform_int_distribution<long long> cold(0, 2 * resident - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < accesses; i++) {
+        unsigned long long r = rng();
+        long long vpn = (r % 10 != 0) ? hot(rng) : cold(rng);
+        mmu.access(vpn * page_size, r % 4 == 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    long long faults = mmu.get_page_faults() - warm_faults;
+
+    std::cout << "Policy:          " << policy << "\n";
+    std::cout << "Resident Pages:  " << resident << " (" << page_size << " B pages)\n";
+    std::cout << "Accesses:        " << accesses << "\n";
+    std::cout << "Page Faults:     " << faults << " (" << mmu.get_dirty_writebacks()
+              << " dirty writebacks)\n";
+    std::cout << "Elapsed:         " << seconds << " s\n";
+    std::cout << "Throughput:      " << (long long)(accesses / seconds) << " accesses/s, "
+              << (long long)(faults / seconds) << " faults/s\n";
+    std::cout << "Peak RSS:        " << peak_rss_kb() << " KB\n";
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+// Interface shared by the physical memory allocators. The cache controller
+// and MMU only talk to memory through this, so any backend can sit behind
+// them.
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+
+    // Returns the start address, or -1 if the request cannot be satisfied
+    virtual long long my_malloc(long long requested_size) = 0;
+    // Frees the block starting exactly at physical_address
+    virtual bool my_free(long long physical_address) = 0;
+    // True if addr lies inside an allocated block
+    virtual bool is_allocated(long long addr) = 0;
+
+    virtual void dump_memory() = 0;
+    virtual void print_stats() = 0;
+    virtual void set_verbose(bool v) = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BUDDY_ALLOCATOR_H
+#define BUDDY_ALLOCATOR_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Allocator.h"
+
+// Binary buddy allocator. Blocks are powers of two (>= 2^min_order bytes)
+// aligned to their own size; block i of order k covers [i << k, (i+1) << k).
+//
+// State is kept in one bitmap pair per order:
+//  - free_map[k] bit i: block i of order k is a free block
+//  - used_map[k] bit i: block i of order k is allocated
+// Free lists are plain stacks of candidate indices; entries whose free bit
+// was cleared by a merge are skipped when popped. Split, merge, free and
+// is_allocated each touch at most one bit per order: O(log N).
+class BuddyAllocator : public Allocator {
+private:
+    long long total_memory_size;
+    int min_order;
+    int max_order;
+
+    std::vector<std::vector<uint64_t>> free_map;
+    std::vector<std::vector<uint64_t>> used_map;
+    std::vector<std::vector<long long>> free_lists;
+
+    // Requested bytes per allocated block, for internal fragmentation
+    std::unordered_map<long long, long long> requested_sizes;
+
+    // Stats
+    long long total_allocations {};
+    long long successful_allocations {};
+    long long used_bytes {};      // Sum of allocated block sizes
+    long long requested_bytes {}; // Sum of requested sizes
+    long long free_bytes {};
+    bool verbose = true; // Per-operation logging (off in batch/quiet mode)
+
+public:
+    // Blocks smaller than min_block bytes are never handed out
+    BuddyAllocator(long long size, long long min_block = 16);
+
+    long long my_malloc(long long requested_size) override;
+    bool my_free(long long physical_address) override;
+    bool is_allocated(long long addr) override;
+    void dump_memory() override;
+    void print_stats() override;
+    void set_verbose(bool v) override { verbose = v; }
+
+private:
+    static bool test_bit(const std::vector<uint64_t>& map, long long i);
+    static void set_bit(std::vector<uint64_t>& map, long long i);
+    static void clear_bit(std::vector<uint64_t>& map, long long i);
+
+    // Order of the allocated block starting at addr, or -1
+    int allocated_order(long long addr);
+    void push_free(int order, long long index);
+    long long pop_free(int order);
+    int largest_free_order();
+};
+
+#endif
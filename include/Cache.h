@@ -1,78 +1,278 @@
 #ifndef CACHE_H
 #define CACHE_H
 
-#include <cmath>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "Latency.h"
 
-class MemorySimulator;
-// class BuddyAllocator;
-//  1. A Single Cache Block (The "Line")
-struct CacheLine {
-  bool valid;
-  unsigned long long tag;
-  unsigned long long last_access_time; // For LRU Policy
+class Allocator;
+class Prefetcher;
 
-  CacheLine() : valid(false), tag(0), last_access_time(0) {}
+// How a level relates to the levels above it (ignored for L1):
+// NINE      - filled on misses, evicts independently (non-inclusive,
+//             non-exclusive)
+// INCLUSIVE - filled on misses; evicting a line back-invalidates every
+//             copy above it
+// EXCLUSIVE - not filled on misses; holds the victims of the level above,
+//             and a hit moves the line up
+enum CacheInclusion { INCLUSION_NINE, INCLUSION_INCLUSIVE, INCLUSION_EXCLUSIVE };
+
+// A line pushed out of a level by allocate() or invalidate()
+struct CacheEviction {
+  bool valid = false; // A valid line was replaced
+  bool dirty = false; // ...and it must be written back
+  unsigned long long address = 0;
 };
 
-// 2. A Single Level of Cache (e.g., L1)
+// 1. A Single Level of Cache (e.g., L1)
+//
+// Interface shared by every cache level implementation. Levels are built
+// with create_cache_level(), which returns a compile-time specialized level
+// for common geometries and a runtime-configured one otherwise (see
+// CacheLevelImpl.h); both produce identical results.
+//
+// Write handling is configurable per level: write-back levels keep a dirty
+// bit and write the whole line below on eviction; write-through levels pass
+// every store below. Write-allocate levels fill on a write miss,
+// no-write-allocate levels let the store bypass them.
+//
+// Each level has a hit latency: the cycles an access spends when it reaches
+// the level, so a hit in L2 costs the L1 and L2 latencies (the usual AMAT
+// recurrence, L1 + miss_L1 * (L2 + miss_L2 * ...)).
 class CacheLevel {
-private:
+protected:
   int level_id;      // 1 for L1, 2 for L2
-  size_t size;       // Total bytes
+  std::string name;  // "L1", "L1I", "L2", ... (shown in stats)
   size_t block_size; // Bytes per block
-  int associativity; // Ways per set (1 = Direct Mapped)
-
-  int num_sets;
-  int index_bits;
-  int offset_bits;
-
-  // The Storage: A Vector of Sets, where each Set is a Vector of Lines
-  std::vector<std::vector<CacheLine>> sets;
+  bool write_back = true;
+  bool write_allocate = true;
+  CacheInclusion inclusion = INCLUSION_NINE;
+  int latency; // Cycles per lookup
 
   // Stats
   long long hits = 0;
   long long misses = 0;
-  unsigned long long access_counter = 0; // Global time for LRU
+  long long dirty_evictions = 0;
+  long long write_traffic = 0; // Bytes written to the level below
+  long long back_invalidations = 0; // Lines removed above (inclusive)
+  unsigned long long cycles = 0;    // Latency charged to lookups
 
 public:
-  CacheLevel(int id, size_t s, size_t bs, int assoc);
+  // Stores are modeled as 8-byte writes (used for write-through traffic)
+  static const int STORE_BYTES = 8;
+
+  CacheLevel(int id, size_t bs)
+      : level_id(id), name("L" + std::to_string(id)), block_size(bs),
+        latency(default_latency(id)) {}
+  virtual ~CacheLevel() {}
+  CacheLevel(const CacheLevel &) = delete;
+  CacheLevel &operator=(const CacheLevel &) = delete;
 
-  // Returns true if HIT, false if MISS
-  bool access(unsigned long long address, bool is_write);
+  // Self-contained single-level access: looks up, fills on a miss and
+  // applies the level's write policy. Returns true if HIT, false if MISS
+  virtual bool access(unsigned long long address, bool is_write) = 0;
 
   // Lookup only (no allocation on miss) - returns true if HIT
-  bool lookup(unsigned long long address);
+  virtual bool lookup(unsigned long long address) = 0;
+
+  // Allocate a clean line (for valid memory fetches); reports the victim.
+  // A dirty victim has already been counted in this level's write traffic.
+  virtual CacheEviction allocate(unsigned long long address) = 0;
 
-  // Allocate a line in the cache (for valid memory fetches)
-  void allocate(unsigned long long address, bool is_write);
+  // Takes a store or writeback arriving from above without touching hit
+  // stats or recency. Returns true if the line is present; a write-back
+  // level then holds it dirty, a write-through level passes it on.
+  virtual bool absorb_write(unsigned long long address) = 0;
+
+  // Drops the line if present (back-invalidation, exclusive moves). The
+  // result says whether it was there and dirty; nothing is counted here.
+  virtual CacheEviction invalidate(unsigned long long address) = 0;
+
+  // Presence check that leaves stats and recency alone (prefetch filtering)
+  virtual bool contains(unsigned long long address) const = 0;
+
+  // Vector tag matching is on by default; results are identical either way
+  virtual void set_simd(bool enabled) {}
+  virtual const char *kernel_name() const = 0;
+  virtual const char *policy_name() const = 0;
+  virtual size_t get_size() const = 0; // Capacity in bytes
+  virtual unsigned long long set_of(unsigned long long address) const = 0;
+
+  void set_write_policy(bool wb, bool wa) {
+    write_back = wb;
+    write_allocate = wa;
+  }
+  bool is_write_back() const { return write_back; }
+  bool is_write_allocate() const { return write_allocate; }
+  void add_write_traffic(long long bytes) { write_traffic += bytes; }
+  void set_inclusion(CacheInclusion inc) { inclusion = inc; }
+  CacheInclusion get_inclusion() const { return inclusion; }
+  void add_back_invalidations(long long n) { back_invalidations += n; }
+  void set_name(const std::string &n) { name = n; }
+  const std::string &get_name() const { return name; }
+  void set_latency(int cycles) { latency = cycles; }
+  int get_latency() const { return latency; }
+  void add_cycles(unsigned long long c) { cycles += c; }
+  unsigned long long get_cycles() const { return cycles; }
+  // 4, 10, 30, then 60 cycles for L1, L2, L3 and anything below
+  static int default_latency(int id) {
+    return id <= 1 ? 4 : id == 2 ? 10 : id == 3 ? 30 : 60;
+  }
 
   void print_stats();
-  void reset_stats();
+  // Adds another level's counters (used to combine set-sharded replicas)
+  void merge_stats(const CacheLevel &other);
 
-private:
-  // Helper to extract parts of the address
-  unsigned long long get_tag(unsigned long long addr);
-  unsigned long long get_index(unsigned long long addr);
+  int get_id() const { return level_id; }
+  size_t get_block_size() const { return block_size; }
+  long long get_hits() const { return hits; }
+  long long get_misses() const { return misses; }
+  long long get_dirty_evictions() const { return dirty_evictions; }
+  long long get_write_traffic() const { return write_traffic; }
+  long long get_back_invalidations() const { return back_invalidations; }
 };
 
-// 3. The Controller (Manages L1 -> L2)
+// Builds a level of `size` bytes. policy is a replacement policy name (see
+// create_replacement_policy); prints the problem and returns nullptr if the
+// geometry is invalid or the policy does not suit this associativity.
+// specialize = false always uses the runtime implementation.
+CacheLevel *create_cache_level(int id, size_t size, size_t block_size,
+                               int assoc, const std::string &policy = "lru",
+                               bool specialize = true);
+
+// 2. The Controller (Manages L1 -> L2 -> ... -> Memory)
+//
+// Data accesses walk `levels` from L1 down. With a split L1, instruction
+// fetches start at the L1I instead and share the levels below it.
+//
+// Any data level that takes demand fills can have a prefetcher. It sees the
+// demand accesses reaching its level (with the load's PC); each candidate
+// it proposes in the same 4K page that is allocated and not already there
+// is brought into the level like a demand miss, but through presence checks
+// that don't count as hits or misses. A prefetched line is tracked until
+// its first demand hit (useful; late if that comes within `latency` demand
+// accesses of the prefetch, i.e. before the line would have arrived) or
+// its eviction (useless).
+//
+// Every access is timed: the latencies of the levels it probes, plus
+// memory_latency if it misses them all. Prefetches and writebacks are off
+// the critical path, except that a late prefetch hit also waits for the
+// part of the fill still outstanding: the fill's cost (levels below plus
+// memory, as for a miss) scaled by the share of `latency` left.
 class CacheController {
 private:
-  CacheLevel *L1;
-  CacheLevel *L2; // Optional, can be nullptr
-  MemorySimulator *std_mem;
+  struct PrefetchState {
+    Prefetcher *prefetcher; // Owned
+    int latency;            // Demand accesses until a prefetch arrives
+    struct Pending {
+      unsigned long long arrival; // Demand access count when it arrives
+      long long cycles;           // What the fill would cost a demand miss
+    };
+    // Prefetched lines not yet used, by block address
+    std::unordered_map<unsigned long long, Pending> pending;
+    long long issued = 0;
+    long long useful = 0;
+    long long late = 0;
+    long long useless = 0;
+  };
+
+  std::vector<CacheLevel *> levels; // Data path, L1(D) first; owned
+  CacheLevel *icache = nullptr;     // Optional L1I; owned
+  std::vector<CacheLevel *> ipath;  // L1I followed by levels[1..]
+  Allocator *std_mem;
+  bool verbose = true; // Per-access logging (off in batch/quiet mode)
+  long long invalid_accesses = 0; // Accesses to unallocated memory
+  long long memory_write_bytes = 0; // Writebacks and stores reaching memory
+  long long walk_accesses = 0;      // Page-table reads from the MMU
+  std::vector<PrefetchState *> prefetch; // Per data level; empty if none
+  unsigned long long clock = 0;           // Demand accesses (prefetch timing)
+  std::vector<unsigned long long> candidates; // Prefetcher output scratch
+
+  // Latency
+  int memory_latency = 200;       // Cycles for a fetch from DRAM
+  long long memory_fetches = 0;   // Accesses that missed every level
+  unsigned long long memory_cycles = 0; // Latency charged to those fetches
+  unsigned long long late_prefetch_cycles = 0; // Waits for late prefetches
+  unsigned long long walk_cycles = 0; // Spent on page-table reads
+  LatencyHistogram latency;       // Demand accesses
 
 public:
   CacheController(CacheLevel *l1, CacheLevel *l2 = nullptr,
-                  MemorySimulator *sm = nullptr);
+                  Allocator *sm = nullptr);
+  // Takes ownership of every level. data_levels must not be empty.
+  CacheController(const std::vector<CacheLevel *> &data_levels,
+                  CacheLevel *l1i, Allocator *sm);
   ~CacheController();
 
-  void access(unsigned long long address,
-              std::string type); // "read" or "write"
+  // pc is the instruction address (0 if unknown), used by prefetchers.
+  // Returns the access's latency in cycles.
+  long long access(unsigned long long address, bool is_write,
+                   bool is_ifetch = false, unsigned long long pc = 0);
+  // A page-table read from the MMU's walker: a silent data read that skips
+  // the allocation check (tables live outside the allocator's range).
+  // Returns its latency; it is not part of the demand histogram.
+  long long access_page_table(unsigned long long address);
   void dump_stats();
+  // Cycles per level and for memory; histogram = false leaves out AMAT and
+  // the distribution (when the MMU reports them for whole accesses)
+  void print_latency(bool histogram = true);
+  void set_memory_latency(int cycles) { memory_latency = cycles; }
+  const LatencyHistogram &get_latency() const { return latency; }
+  void set_verbose(bool v) { verbose = v; }
+  // Attaches p (owned; nullptr removes) to the data level named level,
+  // replacing its prefetcher. Prints the problem and returns false if there
+  // is no such data level or it can't take prefetches (exclusive).
+  bool set_prefetcher(const std::string &level, Prefetcher *p, int latency);
+
+  // Every level, L1I first, then the data path
+  std::vector<CacheLevel *> get_levels() const;
+  // Level by name (case-insensitive), or nullptr
+  CacheLevel *find_level(const std::string &name) const;
+  int num_levels() const { return (int)levels.size() + (icache ? 1 : 0); }
+  long long get_invalid_accesses() const { return invalid_accesses; }
+
+private:
+  typedef std::vector<CacheLevel *> Path;
+
+  // Lookup, fills and the store for one access along path; returns its
+  // latency. Page-walk reads skip the allocation check and the per-access
+  // log.
+  long long access_path(const Path &path, unsigned long long address,
+                   bool is_write, bool page_walk, unsigned long long pc = 0);
+  // Brings address from path[src] (path.size() = memory) into the levels
+  // [top, src) that take it; a hit in an exclusive level moves the line up
+  void bring_up(const Path &path, size_t src, size_t top,
+                unsigned long long address, bool is_write);
+
+  // Sends `bytes` for address down from level index `from`: the first
+  // write-back level holding the line absorbs it, anything else passes on
+  // (charged to the level it leaves) until it reaches memory.
+  void write_down(const Path &path, size_t from, unsigned long long address,
+                  long long bytes);
+  // Allocates in path[level] and disposes of the victim according to the
+  // inclusion policies of that level and the one below
+  void fill(const Path &path, size_t level, unsigned long long address);
+  // Removes address from every level above data level `level`; returns
+  // true if any copy was dirty
+  bool back_invalidate(size_t level, unsigned long long address);
+
+  // Prefetch state of path[j], or nullptr
+  PrefetchState *prefetch_at(const Path &path, size_t j) const;
+  // Drops a tracked prefetched line that left path[j] unused
+  void forget_prefetch(const Path &path, size_t j, unsigned long long block);
+  void issue_prefetches(const Path &path, size_t level,
+                        unsigned long long address);
 };
 
+// Builds a hierarchy from a config file, one level per line:
+//   <name> <size> <block> <assoc> [policy=<name>] [inclusion=<nine|
+//   inclusive|exclusive>] [write=<write-back|write-through>]
+//   [alloc=<write-allocate|no-write-allocate>] [latency=<cycles>]
+// Names are L1I, L1 (or L1D), L2, L3, ...; sizes accept K/M/G suffixes.
+// Prints the problem and returns nullptr if the file is invalid.
+CacheController *load_cache_config(const std::string &path, Allocator *sm,
+                                   bool verbose);
+
 #endif
\ No newline at end of file
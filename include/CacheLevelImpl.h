@@ -0,0 +1,275 @@
+#ifndef CACHE_LEVEL_IMPL_H
+#define CACHE_LEVEL_IMPL_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Cache.h"
+#include "ReplacementPolicy.h"
+#include "TagMatch.h"
+
+// Geometry read from member variables: any power-of-two set count.
+struct RuntimeGeometry {
+  static constexpr bool fixed = false;
+  static constexpr bool unrolled = false;
+  int num_sets;
+  int ways;
+  int offset_bits;
+  int index_bits;
+
+  RuntimeGeometry(size_t size, size_t block_size, int assoc) {
+    ways = assoc;
+    num_sets = size / (block_size * assoc);
+    offset_bits = std::log2(block_size);
+    index_bits = std::log2(num_sets);
+  }
+};
+
+constexpr int log2_exact(long long n) {
+  return n <= 1 ? 0 : 1 + log2_exact(n / 2);
+}
+
+// Geometry fixed at compile time: shifts and masks are constants and way
+// loops under 16 ways have a constant trip count, so the compiler unrolls
+// them. Wider sets still go through the vector tag kernels.
+template <int Sets, int Ways, int BlockSize> struct FixedGeometry {
+  static_assert((Sets & (Sets - 1)) == 0, "Sets must be a power of two");
+  static_assert(Ways >= 1 && Ways <= 64, "Ways must be 1..64");
+  static constexpr bool fixed = true;
+  static constexpr bool unrolled = Ways < 16; // Scalar loops, inlined
+  static constexpr int num_sets = Sets;
+  static constexpr int ways = Ways;
+  static constexpr int offset_bits = log2_exact(BlockSize);
+  static constexpr int index_bits = log2_exact(Sets);
+
+  FixedGeometry(size_t, size_t, int) {}
+};
+
+// Line storage and lookup for one cache level.
+//
+// Line state is stored as structure-of-arrays: way w of set s lives at
+// slot s * ways + w in each buffer, so a set's tags are contiguous and a
+// lookup touches one or two host cache lines.
+//
+// Policy is ReplacementPolicy (virtual calls, any policy) for the runtime
+// level, or one of its final subclasses for specialized levels, where the
+// calls bind statically and inline.
+template <class Geometry, class Policy> class CacheLevelImpl : public CacheLevel {
+private:
+  Geometry geo;
+  std::vector<unsigned long long> tags;
+  std::vector<uint8_t> valid;
+  std::vector<uint8_t> dirty;
+  const TagKernels *kernels; // Set search routines for wide/runtime sets
+  Policy *policy;            // Owned; chooses victims in full sets
+
+public:
+  // Takes ownership of repl
+  CacheLevelImpl(int id, size_t size, size_t block_size, int assoc,
+                 Policy *repl)
+      : CacheLevel(id, block_size), geo(size, block_size, assoc),
+        policy(repl) {
+    size_t lines = (size_t)geo.num_sets * geo.ways;
+    tags.assign(lines, 0);
+    valid.assign(lines, 0);
+    dirty.assign(lines, 0);
+    kernels = &select_tag_kernels(geo.ways);
+    policy->set_kernels(kernels);
+  }
+  ~CacheLevelImpl() override { delete policy; }
+
+  bool access(unsigned long long address, bool is_write) override {
+    size_t set = get_index(address);
+    size_t base = set * geo.ways;
+    unsigned long long tag = get_tag(address);
+
+    // 1. Search the Set for the Tag
+    int way = find_way(base, tag);
+    if (way != -1) {
+      // HIT!
+      hits++;
+      policy->on_hit(set, way);
+      if (is_write)
+        store(base + way);
+      return true;
+    }
+
+    // 2. MISS! Replace a victim (Invalid line OR policy choice)
+    misses++;
+    if (is_write && !write_allocate) {
+      write_traffic += STORE_BYTES; // Store bypasses this level
+    } else {
+      way = fill(set, base, tag, nullptr);
+      if (is_write)
+        store(base + way);
+    }
+    return false; // Return false to signal a MISS (so we can check L2)
+  }
+
+  // Lookup only - checks if address is in cache, updates recency on hit
+  bool lookup(unsigned long long address) override {
+    size_t set = get_index(address);
+    int way = find_way(set * geo.ways, get_tag(address));
+    if (way != -1) {
+      hits++;
+      policy->on_hit(set, way);
+      return true;
+    }
+
+    // MISS - but don't allocate, just record the miss
+    misses++;
+    return false;
+  }
+
+  // Allocate a line in the cache (called only for valid memory fetches)
+  CacheEviction allocate(unsigned long long address) override {
+    size_t set = get_index(address);
+    size_t base = set * geo.ways;
+    unsigned long long tag = get_tag(address);
+    CacheEviction evicted;
+
+    // First check if already in cache (shouldn't happen, but be safe)
+    int way = find_way(base, tag);
+    if (way != -1) {
+      policy->on_hit(set, way);
+      return evicted; // Already present
+    }
+    fill(set, base, tag, &evicted);
+    return evicted;
+  }
+
+  bool absorb_write(unsigned long long address) override {
+    size_t base = get_index(address) * geo.ways;
+    int way = find_way(base, get_tag(address));
+    if (way == -1)
+      return false;
+    if (write_back)
+      dirty[base + way] = 1;
+    return true;
+  }
+
+  CacheEviction invalidate(unsigned long long address) override {
+    size_t base = get_index(address) * geo.ways;
+    CacheEviction dropped;
+    int way = find_way(base, get_tag(address));
+    if (way != -1) {
+      dropped.valid = true;
+      dropped.dirty = dirty[base + way];
+      dropped.address = address & ~((unsigned long long)block_size - 1);
+      valid[base + way] = 0;
+      dirty[base + way] = 0;
+    }
+    return dropped;
+  }
+
+  bool contains(unsigned long long address) const override {
+    return find_way(get_index(address) * geo.ways, get_tag(address)) != -1;
+  }
+
+  void set_simd(bool enabled) override {
+    kernels = &select_tag_kernels(geo.ways, enabled);
+    policy->set_kernels(kernels);
+  }
+  const char *kernel_name() const override {
+    if (Geometry::unrolled)
+      return "specialized";
+    return kernels->name;
+  }
+  const char *policy_name() const override { return policy->name(); }
+  size_t get_size() const override {
+    return (size_t)geo.num_sets * geo.ways * block_size;
+  }
+  unsigned long long set_of(unsigned long long address) const override {
+    return get_index(address);
+  }
+
+private:
+  unsigned long long get_index(unsigned long long addr) const {
+    // Shift out offset, mask to get index
+    return (addr >> geo.offset_bits) & (unsigned long long)(geo.num_sets - 1);
+  }
+
+  unsigned long long get_tag(unsigned long long addr) const {
+    // Shift out offset and index
+    return addr >> (geo.offset_bits + geo.index_bits);
+  }
+
+  // Way holding tag in the set starting at slot base, or -1
+  int find_way(size_t base, unsigned long long tag) const {
+    if constexpr (Geometry::unrolled) {
+      // Constant trip count: fully unrolled
+      const unsigned long long *set_tags = &tags[base];
+      const uint8_t *set_valid = &valid[base];
+      for (int i = 0; i < Geometry::ways; i++) {
+        if (set_tags[i] == tag && set_valid[i])
+          return i;
+      }
+      return -1;
+    } else {
+      return kernels->find_way(&tags[base], &valid[base], geo.ways, tag);
+    }
+  }
+
+  // First invalid way, else the policy's victim
+  int find_victim(size_t set, size_t base) {
+    int way;
+    if constexpr (Geometry::unrolled) {
+      const uint8_t *set_valid = &valid[base];
+      way = -1;
+      for (int i = 0; i < Geometry::ways; i++) {
+        if (!set_valid[i]) {
+          way = i;
+          break;
+        }
+      }
+    } else {
+      way = kernels->find_invalid(&valid[base], geo.ways);
+    }
+    if (way != -1)
+      return way;
+    return policy->victim(set);
+  }
+
+  // A store hitting this level: dirty the line, or pass it through
+  void store(size_t slot) {
+    if (write_back)
+      dirty[slot] = 1;
+    else
+      write_traffic += STORE_BYTES;
+  }
+
+  // Places tag in the set and returns its way. A dirty victim is counted
+  // here (its line goes to the level below) and reported through evicted.
+  int fill(size_t set, size_t base, unsigned long long tag,
+           CacheEviction *evicted) {
+    int way = find_victim(set, base);
+    size_t slot = base + way;
+    if (valid[slot]) {
+      if (dirty[slot]) {
+        dirty_evictions++;
+        write_traffic += block_size;
+      }
+      if (evicted) {
+        evicted->valid = true;
+        evicted->dirty = dirty[slot];
+        evicted->address = (tags[slot] << (geo.offset_bits + geo.index_bits)) |
+                           ((unsigned long long)set << geo.offset_bits);
+      }
+    }
+    valid[slot] = 1;
+    dirty[slot] = 0;
+    tags[slot] = tag;
+    policy->on_fill(set, way);
+    return way;
+  }
+};
+
+// The runtime-configured level: any geometry, any policy
+using DynamicCacheLevel = CacheLevelImpl<RuntimeGeometry, ReplacementPolicy>;
+
+// A level with geometry and policy fixed at compile time
+template <int Sets, int Ways, int BlockSize, class Policy>
+using StaticCacheLevel =
+    CacheLevelImpl<FixedGeometry<Sets, Ways, BlockSize>, Policy>;
+
+#endif
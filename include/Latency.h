@@ -0,0 +1,36 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+// Per-access latencies in power-of-two buckets: bucket 0 holds 0 cycles,
+// bucket b holds [2^(b-1), 2^b). The cache controller and the MMU each keep
+// one to report average memory access time and the latency distribution.
+class LatencyHistogram {
+public:
+  static const int BUCKETS = 48;
+
+private:
+  long long counts[BUCKETS] = {};
+  long long samples = 0;
+  unsigned long long total = 0; // Cycles
+
+public:
+  void record(unsigned long long cycles) {
+    int b = 0;
+    while (b < BUCKETS - 1 && (cycles >> b) != 0)
+      b++;
+    counts[b]++;
+    samples++;
+    total += cycles;
+  }
+
+  long long get_samples() const { return samples; }
+  unsigned long long get_total() const { return total; }
+  double average() const { return samples ? (double)total / samples : 0.0; }
+  // Upper bound of the bucket holding the q-th quantile (0 < q <= 1)
+  unsigned long long percentile(double q) const;
+
+  // AMAT and percentiles, then the non-empty buckets with their share
+  void print() const;
+};
+
+#endif
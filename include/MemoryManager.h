@@ -1,44 +1,123 @@
 #ifndef MEMORY_MANAGER_H
 #define MEMORY_MANAGER_H
 
+#include <set>
+#include <vector>
+#include "Allocator.h"
+
 enum AllocationStrategy {
     FIRST_FIT,
     BEST_FIT,
     WORST_FIT
 };
 
+const int NO_BLOCK = -1; // End of the block list
+
+// Block metadata lives in a contiguous pool (MemorySimulator::blocks) and is
+// linked by pool index, so splits and merges recycle slots instead of going
+// to the heap.
 struct Block {
     int id;
-    int start_address;
-    int size;
+    long long start_address;
+    long long size;
     bool is_free;
-    Block* next;
+    int next; // Pool index of the next block by address
+
+    // Free-address treap links (free blocks only); max_free is the largest
+    // free size in this block's subtree
+    int left = NO_BLOCK;
+    int right = NO_BLOCK;
+    long long max_free = 0;
+    unsigned priority = 0;
     
-    Block(int i, int start, int s, bool free, Block* n = nullptr)
+    Block(int i, long long start, long long s, bool free, int n = NO_BLOCK)
         : id(i), start_address(start), size(s), is_free(free), next(n) {}
 };
 
-class MemorySimulator {
+// Orderings for the block indexes (compare pool indices)
+struct BlockBySize {
+    const std::vector<Block>* pool;
+    bool operator()(int a, int b) const {
+        const Block& x = (*pool)[a];
+        const Block& y = (*pool)[b];
+        if (x.size != y.size) return x.size < y.size;
+        return x.start_address < y.start_address;
+    }
+};
+
+struct BlockByAddress {
+    const std::vector<Block>* pool;
+    bool operator()(int a, int b) const {
+        return (*pool)[a].start_address < (*pool)[b].start_address;
+    }
+};
+
+class MemorySimulator : public Allocator {
 private:
-    Block* head;
-    int total_memory_size;
+    int head;
+    long long total_memory_size;
     int next_id_counter;
     AllocationStrategy current_strategy;
-    int total_allocations {};
-    int successful_allocations {};
-    int failed_allocations {};
+    long long total_allocations {};
+    long long successful_allocations {};
+    long long failed_allocations {};
+    bool verbose = true; // Per-operation logging (off in batch/quiet mode)
+
+    // Block pool. Slot PROBE is reserved as a search key for the indexes.
+    static constexpr int PROBE = 0;
+    std::vector<Block> blocks;
+    std::vector<int> free_slots;
+
+    // Free-block indexes, kept next to the address-ordered list so that no
+    // strategy has to walk every block:
+    //  - free_by_size answers BEST/WORST fit with one tree search
+    //  - free_root is a treap of free blocks by address, each node holding
+    //    its subtree's largest free size, which answers FIRST fit with one
+    //    descent
+    // Ties are broken by lowest address, matching a front-to-back list scan.
+    std::set<int, BlockBySize> free_by_size;
+    int free_root = NO_BLOCK;
+    unsigned priority_state = 0x9e3779b9u; // xorshift state for treap priorities
+    std::vector<int> tree_path; // Scratch: ancestors of the node being updated
+
+    // Every block (free and used) by start address, for range lookups
+    std::set<int, BlockByAddress> all_blocks;
 public:
-    MemorySimulator(int size);
-    bool is_allocated(int addr);
+    MemorySimulator(long long size);
+    MemorySimulator(const MemorySimulator&) = delete; // Indexes point at the pool
+    MemorySimulator& operator=(const MemorySimulator&) = delete;
+
+    bool is_allocated(long long addr) override;
     void set_strategy(AllocationStrategy strategy);
- 
+    void set_verbose(bool v) override { verbose = v; }
 
-    int my_malloc(int requested_size);
-    bool my_free(int physical_address);
-    void dump_memory();
-    void print_stats();
+    long long my_malloc(long long requested_size) override;
+    bool my_free(long long physical_address) override;
+    void dump_memory() override;
+    void print_stats() override;
 private:
-    void merge_free_blocks();
+    void merge_free_blocks(int block);
+    int find_block(long long addr);
+
+    // Block pool
+    int new_block(int id, long long start, long long size, bool free, int next);
+    void delete_block(int block);
+
+    // Free-address treap. Blocks are located by start address, so take a
+    // block out (or replace it) before changing its start.
+    void update_max(int block);
+    void split(int tree, long long start, int& lower, int& upper);
+    int join(int lower, int upper);
+    void tree_insert(int block);
+    void tree_remove(int block);
+    void tree_replace(int block, int replacement);
+    void tree_grow(int block);
+    int* tree_link(int block);
+    void update_path();
+
+    int find_first_fit(long long requested_size);
+    int find_best_fit(long long requested_size);
+    int find_worst_fit(long long requested_size);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,110 @@
+#ifndef MULTI_CORE_H
+#define MULTI_CORE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Cache.h"
+
+enum CoherenceProtocol { COHERENCE_MESI, COHERENCE_MOESI };
+
+// N cores, each with a private L1 and an inclusive private L2, over a
+// shared non-inclusive LLC, kept coherent with MESI or MOESI on a snooping
+// bus.
+//
+// Coherence state is held per line in a directory (sharer bitmask plus the
+// owner's M/E/O state) that stands in for the snoop responses, so a bus
+// transaction costs one lookup instead of one per core. A core holds a line
+// while its L2 does; L2 evictions back-invalidate the L1 and drop the core
+// from the directory.
+//
+// Bus transactions on a private miss or a write:
+//   BusRd   - read miss. Any core holding the line supplies it (a
+//             cache-to-cache transfer); an M owner writes back and drops to
+//             S (MESI) or keeps it as O (MOESI); E drops to S. Without a
+//             holder the line comes from the LLC or memory and is loaded E.
+//   BusRdX  - write miss. As BusRd, but every other copy is invalidated.
+//   BusUpgr - write hit on S or O: invalidates the other copies.
+// A write hit on E upgrades to M silently.
+//
+// Lines with coherence events are tracked individually: invalidations,
+// upgrades and transfers, plus the bytes each core reads and writes from
+// then on (64 chunks per line), which separates false sharing (cores
+// writing disjoint bytes) from true sharing.
+class MultiCoreSystem {
+private:
+  struct Core {
+    CacheLevel *l1; // Owned
+    CacheLevel *l2; // Owned; inclusive of l1
+  };
+  enum OwnerState : uint8_t { OWNER_E, OWNER_M, OWNER_O };
+  struct DirEntry {
+    uint64_t sharers = 0; // Every core holding the line
+    int owner = -1;       // Core in E, M or O, if any
+    OwnerState owner_state = OWNER_E;
+  };
+  struct LineStats {
+    long long invalidations = 0;
+    long long upgrades = 0;
+    long long transfers = 0;
+    std::vector<uint64_t> read_chunks;  // Per core
+    std::vector<uint64_t> write_chunks; // Per core
+  };
+
+  std::vector<Core> cores;
+  CacheLevel *llc; // Owned
+  CoherenceProtocol protocol;
+  Allocator *std_mem;
+  size_t block_size;
+  std::unordered_map<unsigned long long, DirEntry> directory;
+  std::unordered_map<unsigned long long, LineStats> lines;
+
+  // Stats
+  long long bus_reads = 0;
+  long long bus_read_exclusive = 0;
+  long long upgrades = 0;
+  long long invalidations = 0;
+  long long transfers = 0;   // Cache-to-cache
+  long long writebacks = 0;  // Private M/O lines written to the LLC
+  long long memory_reads = 0;
+  long long invalid_accesses = 0;
+  long long bad_core = 0; // Records for a core that doesn't exist
+
+  // Bus transaction for a private miss; leaves the directory updated
+  void miss(int core, unsigned long long block, bool is_write);
+  // Write hit on a line the core holds in S, E or O
+  void write_hit(int core, unsigned long long block);
+  // Drops every copy outside `core`; returns how many there were
+  int invalidate_others(int core, unsigned long long block, DirEntry &entry);
+  // The line left core's L2 (and so its L1)
+  void evict_private(int core, unsigned long long block);
+  void write_back(unsigned long long block);
+  LineStats &line(unsigned long long block);
+
+public:
+  // Takes ownership of the levels (cores.size() == l1s.size() == l2s.size())
+  MultiCoreSystem(const std::vector<CacheLevel *> &l1s,
+                  const std::vector<CacheLevel *> &l2s, CacheLevel *shared,
+                  CoherenceProtocol proto, Allocator *sm);
+  ~MultiCoreSystem();
+  MultiCoreSystem(const MultiCoreSystem &) = delete;
+  MultiCoreSystem &operator=(const MultiCoreSystem &) = delete;
+
+  void access(int core, unsigned long long address, bool is_write);
+
+  // Per-core and LLC stats, bus totals, and the `top` lines with the most
+  // coherence events
+  void print_stats(int top = 10);
+  int num_cores() const { return (int)cores.size(); }
+};
+
+// Builds `num_cores` cores with L1s of l1_size and L2s of 8 * l1_size (both
+// assoc-way) over an LLC of llc_size (16-way, or assoc if that fails).
+// Prints the problem and returns nullptr on bad parameters.
+MultiCoreSystem *create_multicore(int num_cores, size_t l1_size,
+                                  size_t block_size, int assoc,
+                                  size_t llc_size, CoherenceProtocol proto,
+                                  Allocator *sm);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef PAGE_REPLACEMENT_H
+#define PAGE_REPLACEMENT_H
+
+#include <string>
+#include <vector>
+#include "PageTable.h"
+
+// Resident-page bookkeeping and victim choice for the MMU.
+//
+// Resident pages live in a slot table (PageTableEntry::slot points back
+// into it); freed slots are reused, so adding and removing a page is O(1).
+// Every policy picks its victim in O(1) (LRU) or amortized O(1) time (the
+// clocks: each referenced bit they clear was set by an earlier access).
+class PageReplacer {
+protected:
+    struct Frame {
+        unsigned long long vpn;
+        PageTableEntry* pte; // nullptr = free slot
+        int owner;           // Caller's tag for the page's address space (MMU process)
+        int prev, next;      // Intrusive list links (LRU)
+        bool spared;         // Enhanced clock: dirty page already passed over once
+    };
+    std::vector<Frame> frames;
+    std::vector<int> free_slots;
+    size_t resident = 0;
+
+public:
+    virtual ~PageReplacer() {}
+
+    virtual const char* name() const = 0;
+
+    // A page of address space `owner` became resident
+    void add(unsigned long long vpn, PageTableEntry* pte, int owner = 0);
+    // Removes the policy's victim; returns false if nothing is resident
+    bool evict(unsigned long long& vpn, PageTableEntry*& pte, int& owner);
+    // Called on every translation of a resident page (after the MMU sets
+    // its referenced bit)
+    virtual void touch(PageTableEntry* pte) {}
+
+    size_t size() const { return resident; }
+
+    // Calls f(vpn, pte, owner) for every resident page, in slot order
+    template <class F> void for_each(F f) const {
+        for (const Frame& fr : frames) {
+            if (fr.pte) f(fr.vpn, fr.pte, fr.owner);
+        }
+    }
+
+protected:
+    virtual void link(int slot) = 0;   // Slot was just filled
+    virtual void unlink(int slot) = 0; // Slot is about to be freed
+    virtual int victim() = 0;          // Slot to evict (resident > 0)
+};
+
+// Exact LRU: doubly-linked list through the frame slots, most recently
+// used at the head. touch() moves a page to the head, the tail is evicted.
+class LRUPageReplacer : public PageReplacer {
+    int head = -1, tail = -1;
+
+public:
+    const char* name() const override { return "lru"; }
+    void touch(PageTableEntry* pte) override {
+        int slot = pte->slot;
+        if (slot == head) return;
+        unlink(slot);
+        link(slot);
+    }
+
+protected:
+    void link(int slot) override;
+    void unlink(int slot) override;
+    int victim() override { return tail; }
+};
+
+// CLOCK (second chance): the hand sweeps the slots, clearing referenced
+// bits, and evicts the first page whose bit is already clear.
+class ClockPageReplacer : public PageReplacer {
+protected:
+    size_t hand = 0;
+
+public:
+    const char* name() const override { return "clock"; }
+
+protected:
+    void link(int) override {}
+    void unlink(int) override {}
+    int victim() override;
+};
+
+// Enhanced clock: like CLOCK, but an unreferenced dirty page is passed over
+// once (as if queued for writeback) so clean pages go first. A page that is
+// referenced again loses its pass.
+class EnhancedClockPageReplacer : public ClockPageReplacer {
+public:
+    const char* name() const override { return "enhanced-clock"; }
+
+protected:
+    int victim() override;
+};
+
+// Builds a replacer by name (lru, clock / second-chance, enhanced-clock).
+// Prints an error and returns nullptr for unknown names.
+PageReplacer* create_page_replacer(const std::string& name);
+
+#endif
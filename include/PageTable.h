@@ -0,0 +1,111 @@
+#ifndef PAGE_TABLE_H
+#define PAGE_TABLE_H
+
+#include <memory>
+#include <vector>
+
+struct PageTableEntry {
+    bool valid;
+    long long frame_start_addr;
+    bool dirty;
+    bool referenced;                    // Accessed bit, cleared by CLOCK
+    bool huge;                          // PD-level leaf mapping PageTable::ENTRIES base pages
+    int slot;                           // Resident-frame slot (PageReplacer), -1 if none
+    int subpages;                       // Huge pages: index of the MMU's touched-subpage bitmap
+    unsigned long long last_access_time;// For LRU Page Replacement
+
+    PageTableEntry()
+        : valid(false), frame_start_addr(-1), dirty(false), referenced(false), huge(false),
+          slot(-1), subpages(-1), last_access_time(0) {}
+};
+
+// x86-64 style radix page table: four levels of 512 entries (PML4, PDPT,
+// PD, PT), each indexed by 9 bits of the VPN, so it maps 36-bit VPNs (the
+// 48-bit address space with 4K pages). Tables are allocated on first use
+// and never freed, so PageTableEntry pointers stay valid for the table's
+// lifetime.
+//
+// A PD entry can also be a leaf: a huge page covering ENTRIES base pages
+// (2M with 4K pages). Walks to a huge page stop after three reads.
+//
+// Each table is given a physical address in a reserved region (above the
+// allocator's range) so walks can be replayed through the cache. Every
+// address space's tables start at their own base in that region.
+class PageTable {
+public:
+    static const int LEVELS = 4;
+    static const int BITS_PER_LEVEL = 9;
+    static const int ENTRIES = 1 << BITS_PER_LEVEL;
+    static const int ENTRY_BYTES = 8;                        // Size of one table entry in memory
+    static const unsigned long long TABLE_REGION = 1ULL << 56; // Physical base of table pages
+    static const unsigned long long TABLE_SPAN = 1ULL << 40;   // Table bytes per address space
+
+    explicit PageTable(unsigned long long table_base = TABLE_REGION);
+
+    // True if vpn fits in the four levels
+    bool in_range(unsigned long long vpn) const { return (vpn >> (LEVELS * BITS_PER_LEVEL)) == 0; }
+
+    // Hardware-style walk: reads one entry per level until the leaf (a
+    // valid huge page or a PT entry) or a missing table. Counts the
+    // references and, if ref_addrs is given, stores their physical
+    // addresses there (up to LEVELS). Returns the leaf entry or nullptr;
+    // never allocates.
+    PageTableEntry* walk(unsigned long long vpn, unsigned long long* ref_addrs, int& refs);
+
+    // Leaf entry for vpn (the huge page covering it, if valid) or nullptr,
+    // without counting a walk
+    PageTableEntry* find(unsigned long long vpn) const;
+
+    // Base-page leaf entry for vpn, allocating missing tables
+    PageTableEntry& map(unsigned long long vpn);
+    // Huge-page leaf entry covering vpn, allocating missing tables
+    PageTableEntry& map_huge(unsigned long long vpn);
+    // True if any base page in vpn's huge-page range is mapped
+    bool has_base_pages(unsigned long long vpn) const;
+
+    // Calls f(vpn, entry) for every valid entry in VPN order (huge pages
+    // report their first VPN)
+    template <class F> void for_each_valid(F f) const { visit(root.get(), 0, 0, f); }
+
+    // Stats
+    long long get_refs(int level) const { return level_refs[level]; } // 0 = PML4
+    long long get_tables() const { return tables; }
+    static const char* level_name(int level);
+
+private:
+    struct Node {
+        unsigned long long phys_addr;
+        std::vector<std::unique_ptr<Node>> child; // Upper levels
+        std::vector<PageTableEntry> entries;      // PT level; PD level once it maps a huge page
+    };
+
+    unsigned long long base; // Physical address of the first table
+    std::unique_ptr<Node> root;
+    long long tables = 0;
+    long long level_refs[LEVELS] = {0, 0, 0, 0};
+
+    std::unique_ptr<Node> new_node(int level);
+    static int index_at(unsigned long long vpn, int level) {
+        return (vpn >> ((LEVELS - 1 - level) * BITS_PER_LEVEL)) & (ENTRIES - 1);
+    }
+
+    // PD node covering vpn, or nullptr
+    const Node* pd_node(unsigned long long vpn) const;
+
+    template <class F>
+    static void visit(const Node* node, int level, unsigned long long prefix, F& f) {
+        if (level == LEVELS - 1) {
+            for (int i = 0; i < ENTRIES; i++) {
+                if (node->entries[i].valid) f((prefix << BITS_PER_LEVEL) | i, node->entries[i]);
+            }
+            return;
+        }
+        for (int i = 0; i < ENTRIES; i++) {
+            unsigned long long next = (prefix << BITS_PER_LEVEL) | i;
+            if (!node->entries.empty() && node->entries[i].valid) f(next << BITS_PER_LEVEL, node->entries[i]);
+            if (node->child[i]) visit(node->child[i].get(), level + 1, next, f);
+        }
+    }
+};
+
+#endif
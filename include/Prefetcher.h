@@ -0,0 +1,94 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <string>
+#include <vector>
+
+// A hardware prefetcher attached to one cache level. It sees every demand
+// access that reaches the level and proposes block addresses to bring in;
+// the controller filters and issues them (see CacheController).
+class Prefetcher {
+protected:
+  unsigned long long block_size;
+  int degree; // Blocks proposed per trigger
+
+public:
+  Prefetcher(size_t bs, int deg) : block_size(bs), degree(deg) {}
+  virtual ~Prefetcher() {}
+
+  virtual const char *name() const = 0;
+  int get_degree() const { return degree; }
+
+  // One demand access at this level. miss: the level missed; prefetch_hit:
+  // it hit a prefetched line for the first time. Appends candidate block
+  // addresses to out.
+  virtual void observe(unsigned long long address, unsigned long long pc,
+                       bool miss, bool prefetch_hit,
+                       std::vector<unsigned long long> &out) = 0;
+};
+
+// Next-line (tagged): on a miss or a first hit to a prefetched line, fetch
+// the next `degree` blocks.
+class NextLinePrefetcher : public Prefetcher {
+public:
+  using Prefetcher::Prefetcher;
+  const char *name() const override { return "next-line"; }
+  void observe(unsigned long long address, unsigned long long pc, bool miss,
+               bool prefetch_hit,
+               std::vector<unsigned long long> &out) override;
+};
+
+// IP-stride: a direct-mapped table indexed by the load's PC learns each
+// instruction's block stride; after two confirmations it fetches `degree`
+// strides ahead. Accesses without a PC are ignored.
+class IPStridePrefetcher : public Prefetcher {
+  struct Entry {
+    unsigned long long pc = 0;
+    long long last_block = 0;
+    long long stride = 0;
+    int confidence = 0; // 0..3, prefetch at 2+
+  };
+  static const int TABLE_SIZE = 256;
+  std::vector<Entry> table;
+
+public:
+  IPStridePrefetcher(size_t bs, int deg)
+      : Prefetcher(bs, deg), table(TABLE_SIZE) {}
+  const char *name() const override { return "ip-stride"; }
+  void observe(unsigned long long address, unsigned long long pc, bool miss,
+               bool prefetch_hit,
+               std::vector<unsigned long long> &out) override;
+};
+
+// Stream detector (in the style of an L2 streamer): tracks up to 16 streams,
+// one per 4K region. Two misses moving in the same direction confirm a
+// stream, which then runs `degree` blocks ahead of the latest trigger.
+// Streams are replaced LRU.
+class StreamPrefetcher : public Prefetcher {
+  struct Stream {
+    bool valid = false;
+    unsigned long long region = 0;
+    long long last_block = 0;
+    long long front = 0; // Furthest block already proposed
+    int direction = 0;   // +1, -1, or 0 while untrained
+    int confidence = 0;
+    unsigned long long lru = 0;
+  };
+  static const int STREAMS = 16;
+  std::vector<Stream> streams;
+  unsigned long long tick = 0;
+
+public:
+  StreamPrefetcher(size_t bs, int deg) : Prefetcher(bs, deg), streams(STREAMS) {}
+  const char *name() const override { return "stream"; }
+  void observe(unsigned long long address, unsigned long long pc, bool miss,
+               bool prefetch_hit,
+               std::vector<unsigned long long> &out) override;
+};
+
+// Builds a prefetcher by name (next-line, ip-stride, stream). Prints an
+// error and returns nullptr for unknown names or degree < 1.
+Prefetcher *create_prefetcher(const std::string &name, size_t block_size,
+                              int degree);
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TagMatch.h"
+
+// Victim selection for one cache level. CacheLevel fills invalid ways
+// itself and only asks the policy for a victim when the set is full.
+//
+// All state is kept per set (arrays indexed by set or set * ways + way) and
+// each set's decisions depend only on the accesses to that set, so a cache
+// split across workers by set behaves exactly like the whole cache.
+//
+// The per-access hooks are defined inline so that specialized cache levels,
+// which hold a concrete (final) policy type, can inline them.
+class ReplacementPolicy {
+protected:
+  int num_sets;
+  int ways;
+  const TagKernels *kernels; // Shared set-search routines
+
+public:
+  ReplacementPolicy(int sets, int assoc)
+      : num_sets(sets), ways(assoc), kernels(&select_tag_kernels(assoc)) {}
+  virtual ~ReplacementPolicy() {}
+
+  virtual const char *name() const = 0;
+  virtual void on_hit(size_t set, int way) = 0;
+  virtual void on_fill(size_t set, int way) = 0;
+  virtual int victim(size_t set) = 0;
+
+  void set_kernels(const TagKernels *k) { kernels = k; }
+};
+
+// True LRU: a timestamp per line, oldest line is evicted
+class LRUPolicy final : public ReplacementPolicy {
+  std::vector<unsigned long long> last_used;
+  unsigned long long clock = 0;
+
+public:
+  LRUPolicy(int sets, int assoc);
+  const char *name() const override { return "lru"; }
+  void on_hit(size_t set, int way) override {
+    last_used[set * ways + way] = ++clock;
+  }
+  void on_fill(size_t set, int way) override {
+    last_used[set * ways + way] = ++clock;
+  }
+  int victim(size_t set) override {
+    return kernels->find_oldest(&last_used[set * ways], ways);
+  }
+};
+
+// FIFO: timestamp set at fill only, hits do not refresh it
+class FIFOPolicy final : public ReplacementPolicy {
+  std::vector<unsigned long long> filled_at;
+  unsigned long long clock = 0;
+
+public:
+  FIFOPolicy(int sets, int assoc);
+  const char *name() const override { return "fifo"; }
+  void on_hit(size_t, int) override {}
+  void on_fill(size_t set, int way) override {
+    filled_at[set * ways + way] = ++clock;
+  }
+  int victim(size_t set) override {
+    return kernels->find_oldest(&filled_at[set * ways], ways);
+  }
+};
+
+// Random: one xorshift generator per set
+class RandomPolicy final : public ReplacementPolicy {
+  std::vector<uint32_t> state;
+
+public:
+  RandomPolicy(int sets, int assoc);
+  const char *name() const override { return "random"; }
+  void on_hit(size_t, int) override {}
+  void on_fill(size_t, int) override {}
+  int victim(size_t set) override {
+    uint32_t x = state[set];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state[set] = x;
+    return (int)(x % (uint32_t)ways);
+  }
+};
+
+// Tree-PLRU: ways - 1 direction bits per set, each pointing away from the
+// most recently touched half. Needs a power-of-two associativity <= 64.
+class TreePLRUPolicy final : public ReplacementPolicy {
+  std::vector<uint64_t> tree; // Bit n = node n of the heap (root is 1)
+  int levels;
+
+public:
+  TreePLRUPolicy(int sets, int assoc);
+  const char *name() const override { return "tree-plru"; }
+  void on_hit(size_t set, int way) override { touch(set, way); }
+  void on_fill(size_t set, int way) override { touch(set, way); }
+  int victim(size_t set) override {
+    uint64_t bits = tree[set];
+    int node = 1;
+    int way = 0;
+    for (int l = 0; l < levels; l++) {
+      int dir = (bits >> node) & 1;
+      way = (way << 1) | dir;
+      node = 2 * node + dir;
+    }
+    return way;
+  }
+
+private:
+  void touch(size_t set, int way) {
+    uint64_t bits = tree[set];
+    int node = 1;
+    for (int l = levels - 1; l >= 0; l--) {
+      int dir = (way >> l) & 1;
+      // Point the node at the other half
+      if (dir)
+        bits &= ~(1ULL << node);
+      else
+        bits |= 1ULL << node;
+      node = 2 * node + dir;
+    }
+    tree[set] = bits;
+  }
+};
+
+// Bit-PLRU (MRU bits): one bit per way, set on touch; when all would be
+// set, only the touched way keeps its bit. Evicts the lowest clear way.
+// Needs associativity <= 64.
+class BitPLRUPolicy final : public ReplacementPolicy {
+  std::vector<uint64_t> mru;
+  uint64_t full_mask;
+
+public:
+  BitPLRUPolicy(int sets, int assoc);
+  const char *name() const override { return "bit-plru"; }
+  void on_hit(size_t set, int way) override { touch(set, way); }
+  void on_fill(size_t set, int way) override { touch(set, way); }
+  int victim(size_t set) override {
+    return __builtin_ctzll(~mru[set] & full_mask);
+  }
+
+private:
+  void touch(size_t set, int way) {
+    uint64_t bits = mru[set] | (1ULL << way);
+    if (bits == full_mask)
+      bits = 1ULL << way;
+    mru[set] = bits;
+  }
+};
+
+// SRRIP / BRRIP with 2-bit re-reference prediction values. SRRIP inserts
+// at "long" (2); BRRIP inserts at "distant" (3) except every 32nd fill of
+// a set. Hits promote to 0; the victim is the first way at 3, after aging
+// the set until one exists.
+class RRIPPolicy final : public ReplacementPolicy {
+  std::vector<uint8_t> rrpv;
+  std::vector<uint8_t> fills; // BRRIP throttle, per set
+  bool bimodal;
+
+public:
+  RRIPPolicy(int sets, int assoc, bool brrip);
+  const char *name() const override { return bimodal ? "brrip" : "srrip"; }
+  void on_hit(size_t set, int way) override { rrpv[set * ways + way] = 0; }
+  void on_fill(size_t set, int way) override;
+  int victim(size_t set) override;
+};
+
+// Builds a policy by name (lru, fifo, random, tree-plru, bit-plru, srrip,
+// brrip). Prints an error and returns nullptr for unknown names or
+// unsupported associativity.
+ReplacementPolicy *create_replacement_policy(const std::string &name, int sets,
+                                             int ways);
+
+#endif
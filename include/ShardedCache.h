@@ -0,0 +1,22 @@
+#ifndef SHARDED_CACHE_H
+#define SHARDED_CACHE_H
+
+#include <string>
+
+// Set-partitioned parallel replay of one cache level.
+//
+// Every set of a CacheLevel evolves independently (replacement state is
+// per set), so worker t can simulate just the sets with set % threads == t.
+// Each worker owns a replica of the level and touches only its own sets;
+// the main thread splits the trace into per-worker queues one chunk at a
+// time while the workers drain the previous chunk. The merged stats equal
+// a sequential run exactly, for every replacement and write policy.
+//
+// Replays the data accesses of a binary trace through a level of the given
+// geometry and prints its stats. threads = 0 uses one per core. Returns
+// false if the trace or the level can't be set up.
+bool run_sharded_replay(const std::string &trace_path, size_t size,
+                        size_t block_size, int assoc,
+                        const std::string &policy, unsigned threads);
+
+#endif
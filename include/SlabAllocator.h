@@ -0,0 +1,93 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "Allocator.h"
+#include "MemoryManager.h"
+
+// jemalloc-style slab allocator. Small requests are rounded up to a size
+// class and served from slabs: fixed-size runs of memory carved into equal
+// regions, with a bitmap marking the regions in use. Requests above the
+// largest small class are rounded to a large class and go straight to the
+// backing allocator, which also supplies the slabs themselves.
+//
+// Size classes follow jemalloc's spacing: 8, 16, then 16-byte steps up to
+// 64, then four classes per doubling (80, 96, 112, 128, 160, ...).
+class SlabAllocator : public Allocator {
+private:
+    struct Slab {
+        long long start;
+        int bin;   // Size-class index
+        int nfree; // Free regions left
+        std::vector<uint64_t> bitmap; // Bit set = region in use
+    };
+
+    struct Bin {
+        int region_size;
+        int nregs;              // Regions per slab
+        std::set<long long> nonfull; // Start addresses of slabs with free regions
+        int slabs = 0;
+        long long live_regions = 0;
+        long long requests = 0;
+    };
+
+    struct LargeAlloc {
+        long long size;      // Rounded (class) size
+        long long requested;
+    };
+
+    long long total_memory_size;
+    int slab_size;
+    MemorySimulator backing; // Supplies slabs and large allocations
+
+    std::vector<Bin> bins;
+    std::map<long long, Slab> slabs;                          // By start address
+    std::map<long long, LargeAlloc> large_allocs;             // By start address
+    std::unordered_map<long long, long long> requested_sizes; // Small region -> request
+
+    // Stats
+    long long total_allocations {};
+    long long successful_allocations {};
+    long long small_requested {}; // Bytes requested by live small allocations
+    long long small_allocated {}; // Class bytes of live small allocations
+    long long large_requested {};
+    long long large_allocated {};
+    long long slabs_created {};
+    long long slabs_reclaimed {};
+    bool verbose = true; // Per-operation logging (off in batch/quiet mode)
+
+public:
+    static const int DEFAULT_SLAB_SIZE = 4096;
+    static const int MIN_SLAB_SIZE = 64; // Room for the 8..64 byte base classes
+
+    // An invalid slab_bytes is reported and replaced by DEFAULT_SLAB_SIZE
+    SlabAllocator(long long size, int slab_bytes = DEFAULT_SLAB_SIZE);
+
+    // Slab sizes must be a power of two of at least MIN_SLAB_SIZE bytes
+    static bool valid_slab_size(long long bytes) {
+        return bytes >= MIN_SLAB_SIZE && bytes <= (1 << 30) && (bytes & (bytes - 1)) == 0;
+    }
+
+    long long my_malloc(long long requested_size) override;
+    bool my_free(long long physical_address) override;
+    bool is_allocated(long long addr) override;
+    void dump_memory() override;
+    void print_stats() override;
+    void set_verbose(bool v) override { verbose = v; }
+
+private:
+    int small_limit() const { return bins.back().region_size; }
+    int bin_index(long long size) const;
+    static long long large_class(long long size);
+
+    long long alloc_small(int bin, long long requested_size);
+    long long alloc_large(long long requested_size);
+    Slab* find_slab(long long addr);
+    void release_slab(Slab& slab);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+#include <cstdint>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One-pass LRU miss-ratio curves (Mattson's stack algorithm).
+//
+// An LRU cache with A ways hits exactly when the access's stack distance
+// (distinct blocks touched in its set since the last use) is below A, so
+// one pass over a trace yields the miss ratio of every capacity and
+// associativity at once:
+// - Fully associative: distances come from an order-statistics tree of
+//   last-use times, O(log n) per access.
+// - Set associative: for each power-of-two set count, a per-set LRU stack
+//   as deep as the widest associativity reported for it (deeper reuse
+//   misses in all of them).
+class StackDistanceAnalyzer {
+private:
+  typedef __gnu_pbds::tree<unsigned long long, __gnu_pbds::null_type,
+                           std::less<unsigned long long>,
+                           __gnu_pbds::rb_tree_tag,
+                           __gnu_pbds::tree_order_statistics_node_update>
+      OrderTree;
+
+  // LRU stacks for one set count. Entries are block + 1 (0 = empty), MRU
+  // first, `depth` entries per set.
+  struct SetStacks {
+    int sets;
+    int depth;
+    std::vector<unsigned long long> stack;
+    std::vector<long long> hist; // [d] = hits at distance d; [depth] = rest
+  };
+
+  int block_size;
+  int offset_bits;
+  int max_ways;
+  unsigned long long max_size;
+  unsigned long long accesses = 0;
+
+  // Fully associative
+  std::unordered_map<unsigned long long, unsigned long long> last_use;
+  OrderTree recent;             // Last-use time of every block seen
+  std::vector<long long> fa_hist; // [d] = reuses at distance d (capped)
+  long long fa_beyond = 0;        // Cold misses and reuses past the cap
+
+  std::vector<SetStacks> set_counts; // 1, 2, 4, ... sets
+
+public:
+  // Curves cover capacities up to max_size bytes and set-associative
+  // caches up to max_ways ways (both rounded down to powers of two)
+  StackDistanceAnalyzer(int block_size, unsigned long long max_size,
+                        int max_ways = 16);
+
+  void access(unsigned long long address);
+  void print_curves() const;
+
+  unsigned long long get_accesses() const { return accesses; }
+  // Misses of an LRU cache of `capacity` bytes and `ways` ways (0 = fully
+  // associative), or -1 if that configuration is not covered
+  long long misses(unsigned long long capacity, int ways) const;
+};
+
+// Replays the data and instruction accesses of a binary trace through an
+// analyzer and prints the curves. Returns false if the trace can't be read.
+bool run_stack_distance(const std::string &trace_path, int block_size,
+                        unsigned long long max_size, int max_ways);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include <string>
+#include <vector>
+#include "ReplacementPolicy.h"
+
+struct PageTableEntry;
+
+// Page sizes a TLB level can hold
+enum TLBPageSizes { TLB_BASE = 1, TLB_HUGE = 2, TLB_BOTH = 3 };
+
+// One set-associative TLB level. Entries cache a pointer to the page's
+// PageTableEntry, so a hit translates (and updates the page's LRU time and
+// dirty bit) without touching the page table.
+//
+// Tags are (asid << ASID_SHIFT) | (page number << 1) | huge, where a huge
+// page's number is its first VPN >> PageTable::BITS_PER_LEVEL; the page
+// number alone picks the set. A level holding both sizes probes for each.
+// The address-space ID lets translations of several processes live side
+// by side, so a context switch needs no flush.
+class TLBLevel {
+private:
+    std::string name;
+    int num_sets;
+    int ways;
+    int sizes; // TLBPageSizes
+    std::vector<unsigned long long> tags; // set * ways + way
+    std::vector<uint8_t> valid;
+    std::vector<PageTableEntry*> entries;
+    const TagKernels* kernels;
+    ReplacementPolicy* policy; // Owned
+    int latency;               // Cycles per lookup
+
+    // Stats
+    long long hits = 0;
+    long long misses = 0;
+
+    PageTableEntry* probe(unsigned long long page, bool huge, int asid);
+    static unsigned long long make_tag(unsigned long long page, bool huge, int asid) {
+        return ((unsigned long long)asid << ASID_SHIFT) | (page << 1) | huge;
+    }
+
+public:
+    static const int ASID_SHIFT = 48; // Above the 36-bit VPN
+
+    // Takes ownership of repl
+    TLBLevel(const std::string& name, int num_entries, int assoc, ReplacementPolicy* repl,
+             int page_sizes = TLB_BOTH, int cycles = 1);
+    ~TLBLevel();
+    TLBLevel(const TLBLevel&) = delete;
+    TLBLevel& operator=(const TLBLevel&) = delete;
+
+    // Cached entry covering vpn in address space asid (counted as a hit),
+    // or nullptr (counted as a miss unless count_miss is false)
+    PageTableEntry* lookup(unsigned long long vpn, int asid, bool count_miss = true);
+    void insert(unsigned long long vpn, int asid, PageTableEntry* pte);
+    void invalidate(unsigned long long vpn, bool huge, int asid);
+    // Drops every entry of asid, or every entry if asid is -1
+    void flush(int asid = -1);
+    void add_miss() { misses++; }
+
+    bool holds(bool huge) const { return sizes & (huge ? TLB_HUGE : TLB_BASE); }
+    void set_latency(int cycles) { latency = cycles; }
+    int get_latency() const { return latency; }
+    // Bytes currently mapped by valid entries
+    unsigned long long reach(long long page_size) const;
+
+    void print_stats(long long page_size) const;
+    long long get_hits() const { return hits; }
+    long long get_misses() const { return misses; }
+};
+
+// Multi-level TLB: a first-level DTLB, an optional first-level huge-page
+// DTLB probed in parallel with it, and an optional second-level STLB that
+// holds both page sizes. A translation found in the STLB is copied into
+// the first-level array for its size; one found by a page walk is inserted
+// into that array and the STLB. A first-level miss is counted against both
+// first-level arrays.
+class TLB {
+private:
+    TLBLevel* dtlb;      // Owned; holds huge pages too unless dtlb_huge is set
+    TLBLevel* dtlb_huge; // Optional, owned
+    TLBLevel* stlb;      // Optional, owned
+
+    TLBLevel* first_level(const PageTableEntry* pte) const;
+
+public:
+    TLB(TLBLevel* l1, TLBLevel* l1_huge, TLBLevel* l2) : dtlb(l1), dtlb_huge(l1_huge), stlb(l2) {}
+    ~TLB();
+    TLB(const TLB&) = delete;
+    TLB& operator=(const TLB&) = delete;
+
+    // Adds the latency of each level probed (the first-level arrays count
+    // once, being probed in parallel) to cycles
+    PageTableEntry* lookup(unsigned long long vpn, int asid, long long& cycles);
+    void insert(unsigned long long vpn, int asid, PageTableEntry* pte);
+    // Shootdown: drop the page covering vpn from every level (it was evicted)
+    void invalidate(unsigned long long vpn, bool huge, int asid);
+    // Drops asid's entries (-1: all) from every level
+    void flush(int asid = -1);
+
+    // level is "dtlb" (both first-level arrays) or "stlb"; false if absent
+    bool set_latency(const std::string& level, int cycles);
+
+    void print_stats(long long page_size) const;
+};
+
+// Builds a DTLB of l1_entries / l1_ways, a huge-page DTLB of huge_entries /
+// huge_ways if huge_entries > 0, and an STLB of l2_entries / l2_ways if
+// l2_entries > 0 (1 cycle per first-level lookup, 7 per STLB lookup).
+// Entry counts must give a power-of-two set count. Prints
+// the problem and returns nullptr on bad geometry or policy.
+TLB* create_tlb(int l1_entries, int l1_ways, int l2_entries, int l2_ways,
+                const std::string& policy = "lru", int huge_entries = 0, int huge_ways = 0);
+
+#endif
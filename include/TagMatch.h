@@ -0,0 +1,28 @@
+#ifndef TAG_MATCH_H
+#define TAG_MATCH_H
+
+#include <cstdint>
+
+// Per-set search kernels used by CacheLevel. Each works on one set's slice
+// of the structure-of-arrays line buffers (ways contiguous entries).
+//
+// The vector kernels (AVX2, SSE4.2) compare a whole set's tags at once and,
+// for 32+ ways on AVX2, find the LRU way with a vector min-reduction. They
+// return exactly what the scalar kernels return, including the lowest way
+// on ties.
+struct TagKernels {
+  const char *name;
+  // Lowest valid way whose tag matches, or -1
+  int (*find_way)(const unsigned long long *tags, const uint8_t *valid,
+                  int ways, unsigned long long tag);
+  // Lowest invalid way, or -1 if the set is full
+  int (*find_invalid)(const uint8_t *valid, int ways);
+  // Lowest way holding the smallest timestamp
+  int (*find_oldest)(const unsigned long long *stamps, int ways);
+};
+
+// Best kernels for this host CPU and associativity. Sets under 16 ways (and
+// non-x86 hosts) use the scalar loops; allow_simd = false forces them.
+const TagKernels &select_tag_kernels(int ways, bool allow_simd = true);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Operation stored in a trace record
+enum TraceOp : uint8_t {
+    TRACE_READ = 0,
+    TRACE_WRITE = 1,
+    TRACE_IFETCH = 2, // Instruction fetch (treated as a read)
+    TRACE_MALLOC = 3, // 'size' holds the requested bytes
+    TRACE_FREE = 4    // 'address' holds the block start
+};
+
+// One fixed-width (24 byte) record. Files are written in host byte order
+// (little-endian on every platform we build for).
+struct TraceRecord {
+    uint64_t address;  // Accessed address (virtual if an MMU is active)
+    uint64_t pc;       // Instruction address, 0 if unknown
+    uint32_t size;     // Access size in bytes, or request size for MALLOC
+    uint16_t pid;      // Process ID, 0 if unknown
+    uint8_t op;        // TraceOp
+    uint8_t core;      // Issuing core (multi-core replay), 0 if unknown
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord must stay 24 bytes");
+
+// File header, followed directly by record_count records
+struct TraceHeader {
+    char magic[8];         // "MEMTRACE"
+    uint32_t version;      // TRACE_VERSION
+    uint32_t record_size;  // sizeof(TraceRecord)
+    uint64_t record_count;
+};
+
+static_assert(sizeof(TraceHeader) == 24, "TraceHeader must stay 24 bytes");
+
+const uint32_t TRACE_VERSION = 1;
+
+// Read-only view of a binary trace. The file is memory-mapped, so records are
+// used in place with no per-record allocation or parsing.
+class TraceFile {
+private:
+    const TraceRecord* records = nullptr;
+    size_t count = 0;
+
+    // Mapping state
+    void* map_base = nullptr;
+    size_t map_length = 0;
+    std::vector<TraceRecord> buffer; // Used where mmap is unavailable
+
+public:
+    TraceFile() = default;
+    ~TraceFile();
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    // Returns false (and prints the reason) if the file is not a valid trace
+    bool open(const std::string& path);
+    void close();
+
+    const TraceRecord* begin() const { return records; }
+    const TraceRecord* end() const { return records + count; }
+    size_t size() const { return count; }
+};
+
+// Streams records to a binary trace file. The header's record count is
+// patched in by close().
+class TraceWriter {
+private:
+    std::ofstream out;
+    uint64_t count = 0;
+
+public:
+    ~TraceWriter();
+
+    bool open(const std::string& path);
+    void write(const TraceRecord& record);
+    void close();
+
+    uint64_t records_written() const { return count; }
+};
+
+// Reads an unsigned number at p the way command files write them: decimal,
+// or hex after an explicit 0x prefix (a leading 0 is not octal, and a sign
+// is not accepted). On success sets end past the digits; returns false if p
+// holds no number or it overflows 64 bits.
+bool parse_number(const char* p, const char*& end, uint64_t& value);
+
+// Converts a text trace into the binary format.
+// format: "text"   - simulator command files (access/malloc/free lines)
+//         "lackey" - valgrind --tool=lackey --trace-mem=yes output
+//         "perf"   - perf mem report -D output
+bool convert_trace(const std::string& format, const std::string& in_path,
+                   const std::string& out_path);
+
+#endif
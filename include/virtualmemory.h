@@ -1,51 +1,204 @@
 #ifndef VIRTUAL_MEMORY_H
 #define VIRTUAL_MEMORY_H
 
-#include <map>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 #include "Cache.h"
-#include "MemoryManager.h"
+#include "Allocator.h"
+#include "PageTable.h"
+#include "PageReplacement.h"
+#include "TLB.h"
+#include "Latency.h"
 
-struct PageTableEntry {
-    bool valid;          
-    int frame_start_addr; 
-    bool dirty;          
-    int last_access_time;// For LRU Page Replacement
+// When a fault may map a huge page (PageTable::ENTRIES base pages, 2M with
+// 4K pages) instead of a base page, like Linux transparent huge pages
+enum HugePageMode {
+    HUGE_NEVER,   // Base pages only
+    HUGE_ALWAYS,  // Any fault in an empty, aligned huge-page range
+    HUGE_MADVISE  // Only inside regions added with add_huge_region
+};
 
-    PageTableEntry() : valid(false), frame_start_addr(-1), dirty(false), last_access_time(0) {}
+// Which resident pages a fault may evict once physical memory is full
+enum ReplacementScope {
+    SCOPE_GLOBAL, // Any process's pages, under one policy over all frames
+    SCOPE_LOCAL   // The faulting process's own pages (another's if it has none)
 };
 
+// Processes (trace PIDs) get their own page tables and TLB address-space
+// IDs but share the physical frames, the cache and the replacement policy.
+//
+// Every access is timed end to end: TLB lookups, the page walk on a TLB
+// miss (walk_latency per table read, or the cache's latency for each read
+// with walk_cache on), the fault handler's disk read, and the data access
+// through the cache (or memory_latency without one).
 class MMU {
+public:
+    static const int MAX_ASIDS = 4096; // 12-bit ASIDs (x86-64 PCIDs)
+
 private:
+    // One address space: its page table (VPN -> PTE), huge-page regions and
+    // stats. Created on the first access by its PID and kept until the MMU
+    // is destroyed.
+    struct Process {
+        unsigned pid;
+        int index; // Position in processes, and the PageReplacer owner tag
+        int asid;
+        PageTable page_table;
+        PageReplacer* replacer = nullptr; // Local scope only: its resident pages (owned)
+        std::vector<std::pair<unsigned long long, unsigned long long>> huge_regions; // [first, last) VPNs
+
+        long long accesses = 0;
+        long long page_faults = 0;
+        long long evictions = 0; // Its pages evicted, by any process's faults
+        long long resident = 0;  // Resident pages, a huge page counting once
+        long long resident_huge = 0;
+
+        Process(unsigned id, int idx, unsigned long long table_base)
+            : pid(id), index(idx), asid(idx % MAX_ASIDS), page_table(table_base) {}
+        ~Process() { delete replacer; }
+    };
+
     // Config
-    int page_size;
-    int timer; // Global counter for LRU
+    long long page_size;
+    unsigned long long timer; // Global counter for LRU
 
-    // The Page Table: Maps VPN (Virtual Page Number) -> PTE
-    std::map<int, PageTableEntry> page_table;
+    std::vector<std::unique_ptr<Process>> processes;
+    std::unordered_map<unsigned, int> process_index; // PID -> index
+    Process* current;                                // Running process
+    std::vector<int> asid_holder; // Process whose translations each ASID tags, -1 if none
+    bool use_asids = true;        // Off: the TLB is flushed on every context switch
+    bool walk_to_cache = false; // Replay page-walk reads through the cache
 
     // References to Hardware
     CacheController* cache;
-    MemorySimulator* std_mem;
+    Allocator* std_mem;
+    TLB* tlb = nullptr; // Optional, owned; consulted before the page table
+
+    // Resident pages and the victim policy (owned, never null). Under local
+    // scope it holds no pages and each process has a replacer of its kind.
+    PageReplacer* replacer;
+    ReplacementScope scope = SCOPE_GLOBAL;
 
-    // Track allocated VPNs to help with replacement
-    std::vector<int> loaded_pages; 
+    // Huge pages
+    HugePageMode huge_mode = HUGE_NEVER;
+    // Base pages touched inside each resident huge page (PageTableEntry::subpages)
+    std::vector<std::array<uint64_t, PageTable::ENTRIES / 64>> subpage_bits;
+    std::vector<int> free_subpage_bits;
+
+    // Stats
+    long long accesses = 0;
+    long long page_faults = 0;
+    long long evictions = 0;
+    long long dirty_writebacks = 0;
+    long long page_walks = 0; // Translations that missed the TLB
+    long long writeback_bytes = 0;
+    long long huge_faults = 0;    // Faults that mapped a huge page
+    long long huge_fallbacks = 0; // Huge-eligible faults with no free huge frame
+    long long huge_evictions = 0;
+    long long resident_huge = 0;
+    long long context_switches = 0;
+    long long tlb_flushes = 0;
+
+    // Latency (cycles)
+    int walk_latency = 20;            // Per page-table read not sent to the cache
+    long long fault_latency = 300000; // Disk read of a faulting page (~100 us)
+    int memory_latency = 200;         // Data access without a cache
+    unsigned long long tlb_cycles = 0;
+    unsigned long long walk_cycles = 0;
+    unsigned long long fault_cycles = 0;
+    unsigned long long data_cycles = 0; // Cache and memory, after translation
+    LatencyHistogram latency;
+
+    bool verbose = true; // Per-access logging (off in batch/quiet mode)
 
 public:
-    MMU(int pg_size, CacheController* c, MemorySimulator* sm);
+    MMU(long long pg_size, CacheController* c, Allocator* sm);
+    ~MMU();
+    MMU(const MMU&) = delete;
+    MMU& operator=(const MMU&) = delete;
+
+    // Installs a TLB (replacing any previous one); takes ownership
+    void set_tlb(TLB* t);
+    // Points translated accesses at a new cache (not owned; nullptr = none)
+    void set_cache(CacheController* c) { cache = c; }
+    // Switches the page replacement policy; takes ownership. Resident pages
+    // carry over in LRU order (least recent first).
+    void set_page_replacer(PageReplacer* r);
+    // Switches between global and per-process replacement; resident pages
+    // carry over as above
+    void set_replacement_scope(ReplacementScope s);
+    // With ASIDs off, every context switch flushes the TLB
+    void set_asids(bool on) { use_asids = on; }
+    void set_walk_latency(int cycles) { walk_latency = cycles; }
+    void set_fault_latency(long long cycles) { fault_latency = cycles; }
+    void set_memory_latency(int cycles) { memory_latency = cycles; }
+    // level is "dtlb" or "stlb"; false without a TLB (or an STLB)
+    bool set_tlb_latency(const std::string& level, int cycles) {
+        return tlb && tlb->set_latency(level, cycles);
+    }
+    // Sends each page-walk read to the cache as a data read
+    void set_walk_to_cache(bool on) { walk_to_cache = on; }
+    void set_huge_pages(HugePageMode mode) { huge_mode = mode; }
+    // Marks [va, va + length) of the running process for huge pages under
+    // HUGE_MADVISE. Only the whole huge-page ranges inside it qualify;
+    // returns false if none do.
+    bool add_huge_region(unsigned long long va, unsigned long long length);
 
-    // Main Interface: Accepts a Virtual Address
-    void access(int virtual_address, std::string type);
+    // Makes pid the running process, creating its address space on first
+    // use. Later accesses translate through its page table.
+    void context_switch(unsigned pid) {
+        if (pid != current->pid) switch_to(pid);
+    }
+    unsigned get_pid() const { return current->pid; }
+
+    // Main Interface: Accepts a Virtual Address (full 64-bit range)
+    // Instruction fetches reach the cache's L1I when it has one; pc goes
+    // to the cache's prefetchers
+    void access(unsigned long long virtual_address, bool is_write, bool is_ifetch = false,
+                unsigned long long pc = 0);
 
     // Debugging
     void print_page_table();
+    void print_stats();
+    // Context switches and one row per process: faults, fault rate, RSS
+    void print_processes();
+    // AMAT, the cycles spent per component, the latency histogram, then the
+    // cache's per-level breakdown
+    void print_latency();
+    const LatencyHistogram& get_latency() const { return latency; }
+    void set_verbose(bool v) { verbose = v; }
+
+    long long get_accesses() const { return accesses; }
+    long long get_page_faults() const { return page_faults; }
+    long long get_page_walks() const { return page_walks; }
+    long long get_evictions() const { return evictions; }
+    long long get_dirty_writebacks() const { return dirty_writebacks; }
+    long long get_huge_faults() const { return huge_faults; }
+    long long get_huge_fallbacks() const { return huge_fallbacks; }
+    long long get_context_switches() const { return context_switches; }
 
 private:
+    int add_process(unsigned pid);
+    void switch_to(unsigned pid);
+    PageReplacer* replacer_for(const Process& p) const { return scope == SCOPE_LOCAL ? p.replacer : replacer; }
+    // Moves every resident page into `global` (and, under local scope, new
+    // per-process replacers of its kind); deletes the old replacers
+    void rebuild_replacers(PageReplacer* global, ReplacementScope s);
+    long long resident_pages() const;
+
     // Helper to handle Page Faults
-    bool handle_page_fault(int vpn);
+    bool handle_page_fault(unsigned long long vpn);
+    // Huge-page path of a fault: false if vpn's range doesn't qualify or no
+    // huge frame could be allocated (the fault then maps a base page)
+    bool huge_eligible(unsigned long long vpn) const;
+    bool map_huge_page(unsigned long long vpn);
     
-    // Helper to perform Page Replacement (if memory is full)
+    // Helper to perform Page Replacement (if memory is full) for a fault of
+    // the running process
     void evict_victim();
 };
 
@@ -0,0 +1,235 @@
+#include <iostream>
+#include "../../include/BuddyAllocator.h"
+
+BuddyAllocator::BuddyAllocator(long long size, long long min_block) {
+    total_memory_size = size;
+
+    min_order = 0;
+    while ((1LL << (min_order + 1)) <= min_block) min_order++;
+    max_order = min_order;
+    while ((1LL << (max_order + 1)) <= size) max_order++;
+
+    free_map.resize(max_order + 1);
+    used_map.resize(max_order + 1);
+    free_lists.resize(max_order + 1);
+    for (int k = min_order; k <= max_order; k++) {
+        size_t blocks = ((size_t)size >> k) + 1;
+        free_map[k].assign((blocks + 63) / 64, 0);
+        used_map[k].assign((blocks + 63) / 64, 0);
+    }
+
+    // Cover [0, size) with the largest aligned blocks that fit. Any tail
+    // smaller than the minimum block is unusable.
+    long long addr = 0;
+    while (addr + (1LL << min_order) <= size) {
+        int k = max_order;
+        while (k > min_order && ((addr & ((1LL << k) - 1)) != 0 || addr + (1LL << k) > size)) k--;
+        push_free(k, addr >> k);
+        free_bytes += 1LL << k;
+        addr += 1LL << k;
+    }
+}
+
+// --- Bitmap Helpers ---
+
+bool BuddyAllocator::test_bit(const std::vector<uint64_t>& map, long long i) {
+    size_t word = (size_t)(i >> 6);
+    return word < map.size() && ((map[word] >> (i & 63)) & 1);
+}
+
+void BuddyAllocator::set_bit(std::vector<uint64_t>& map, long long i) {
+    map[(size_t)(i >> 6)] |= 1ULL << (i & 63);
+}
+
+void BuddyAllocator::clear_bit(std::vector<uint64_t>& map, long long i) {
+    map[(size_t)(i >> 6)] &= ~(1ULL << (i & 63));
+}
+
+void BuddyAllocator::push_free(int order, long long index) {
+    set_bit(free_map[order], index);
+    std::vector<long long>& list = free_lists[order];
+    list.push_back(index);
+
+    // Merges leave stale entries behind; rebuild from the bitmap before they
+    // outnumber the blocks this order can hold.
+    size_t capacity = ((size_t)total_memory_size >> order) + 1;
+    if (list.size() > 2 * capacity + 64) {
+        list.clear();
+        for (size_t i = 0; i < capacity; i++) {
+            if (test_bit(free_map[order], (long long)i)) list.push_back((long long)i);
+        }
+    }
+}
+
+// Pops a free block of this order, skipping stale entries. Returns -1 if none.
+long long BuddyAllocator::pop_free(int order) {
+    std::vector<long long>& list = free_lists[order];
+    while (!list.empty()) {
+        long long index = list.back();
+        list.pop_back();
+        if (test_bit(free_map[order], index)) {
+            clear_bit(free_map[order], index);
+            return index;
+        }
+    }
+    return -1;
+}
+
+int BuddyAllocator::allocated_order(long long addr) {
+    for (int k = min_order; k <= max_order; k++) {
+        if (addr & ((1LL << k) - 1)) break; // Not aligned to any larger block
+        if (test_bit(used_map[k], addr >> k)) return k;
+    }
+    return -1;
+}
+
+int BuddyAllocator::largest_free_order() {
+    for (int k = max_order; k >= min_order; k--) {
+        for (uint64_t word : free_map[k]) {
+            if (word) return k;
+        }
+    }
+    return -1;
+}
+
+// --- Allocation ---
+
+long long BuddyAllocator::my_malloc(long long requested_size) {
+    total_allocations++;
+
+    // Smallest order that holds the request
+    int order = min_order;
+    while (order <= max_order && (1LL << order) < requested_size) order++;
+
+    int k = order;
+    long long index = -1;
+    if (requested_size > 0) {
+        for (; k <= max_order; k++) {
+            index = pop_free(k);
+            if (index != -1) break;
+        }
+    }
+
+    if (index == -1) {
+        if (verbose) std::cout << "Allocation failed: Not enough memory!\n";
+        return -1;
+    }
+
+    // Split down to the target order, freeing the upper halves
+    while (k > order) {
+        k--;
+        index <<= 1;
+        push_free(k, index + 1);
+    }
+
+    set_bit(used_map[order], index);
+    long long addr = index << order;
+    requested_sizes[addr] = requested_size;
+    used_bytes += 1LL << order;
+    requested_bytes += requested_size;
+    free_bytes -= 1LL << order;
+    successful_allocations++;
+
+    if (verbose) std::cout << "Allocated " << requested_size << " bytes at " << addr
+                           << " (Block " << (1LL << order) << " bytes)\n";
+    return addr;
+}
+
+bool BuddyAllocator::my_free(long long physical_address) {
+    int order = (physical_address >= 0 && physical_address < total_memory_size)
+                    ? allocated_order(physical_address)
+                    : -1;
+    if (order == -1) {
+        if (verbose) std::cout << "Error: MMU tried to free invalid address " << physical_address << "\n";
+        return false;
+    }
+
+    long long index = physical_address >> order;
+    clear_bit(used_map[order], index);
+    used_bytes -= 1LL << order;
+    requested_bytes -= requested_sizes[physical_address];
+    requested_sizes.erase(physical_address);
+    free_bytes += 1LL << order;
+
+    // Merge with the buddy while it is free
+    int k = order;
+    while (k < max_order && test_bit(free_map[k], index ^ 1)) {
+        clear_bit(free_map[k], index ^ 1); // Its free-list entry goes stale
+        index >>= 1;
+        k++;
+    }
+    push_free(k, index);
+
+    if (verbose) std::cout << "Block at address " << physical_address << " freed.\n";
+    return true;
+}
+
+bool BuddyAllocator::is_allocated(long long addr) {
+    if (addr < 0 || addr >= total_memory_size) return false;
+    for (int k = min_order; k <= max_order; k++) {
+        if (test_bit(used_map[k], addr >> k)) return true;
+    }
+    return false;
+}
+
+// --- Reporting ---
+
+void BuddyAllocator::dump_memory() {
+    std::cout << "\n--- Memory Dump (Buddy) ---\n";
+    long long addr = 0;
+    while (addr < total_memory_size) {
+        // Find the block that starts here
+        int found = -1;
+        bool used = false;
+        for (int k = min_order; k <= max_order && !(addr & ((1LL << k) - 1)); k++) {
+            if (test_bit(used_map[k], addr >> k)) { found = k; used = true; break; }
+            if (test_bit(free_map[k], addr >> k)) { found = k; break; }
+        }
+
+        if (found == -1) {
+            std::cout << "[" << addr << " - " << total_memory_size - 1 << "] UNUSABLE\n";
+            break;
+        }
+
+        long long block = 1LL << found;
+        std::cout << "[" << addr << " - " << addr + block - 1 << "] ";
+        if (used) {
+            std::cout << "USED (" << requested_sizes[addr] << "/" << block << " bytes)\n";
+        } else {
+            std::cout << "FREE (" << block << " bytes)\n";
+        }
+        addr += block;
+    }
+    std::cout << "---------------------------\n";
+}
+
+void BuddyAllocator::print_stats() {
+    int largest = largest_free_order();
+    long long largest_free_block = (largest == -1) ? 0 : (1LL << largest);
+    long long internal_fragmentation = used_bytes - requested_bytes;
+
+    double ext_frag_percent = 0.0;
+    if (free_bytes > 0) {
+        ext_frag_percent = 1.0 - ((double)largest_free_block / free_bytes);
+    }
+    double int_frag_percent = 0.0;
+    if (used_bytes > 0) {
+        int_frag_percent = (double)internal_fragmentation / used_bytes;
+    }
+
+    std::cout << "\n--- Statistics (Buddy) ---\n";
+    std::cout << "Total Memory:       " << total_memory_size << "\n";
+    std::cout << "Min Block:          " << (1LL << min_order) << "\n";
+    std::cout << "Used Memory:        " << used_bytes << " ("
+              << ((double)used_bytes / total_memory_size) * 100 << "%)\n";
+    std::cout << "Requested Memory:   " << requested_bytes << "\n";
+    std::cout << "Free Memory:        " << free_bytes << "\n";
+    std::cout << "Largest Free Block: " << largest_free_block << "\n";
+    std::cout << "Total Requests:     " << total_allocations << "\n";
+    std::cout << "Success Rate:       " << successful_allocations << "/"
+              << total_allocations << "\n";
+    std::cout << "Internal Frag:      " << internal_fragmentation << " ("
+              << int_frag_percent * 100 << "%)\n";
+    std::cout << "External Frag:      " << ext_frag_percent * 100 << "%\n";
+    std::cout << "--------------------------\n";
+}
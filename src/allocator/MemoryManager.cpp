@@ -1,181 +1,362 @@
+#include <climits>
 #include <iostream>
+#include <iterator>
 #include "../../include/MemoryManager.h" 
 
-MemorySimulator::MemorySimulator(int size) {
+MemorySimulator::MemorySimulator(long long size)
+    : free_by_size(BlockBySize{&blocks}), all_blocks(BlockByAddress{&blocks}) {
     total_memory_size = size;
     next_id_counter = 1;
-    head = new Block(-1, 0, size, true, nullptr);
+    blocks.emplace_back(-1, 0, 0, true); // PROBE slot
+    head = new_block(-1, 0, size, true, NO_BLOCK);
     current_strategy = FIRST_FIT;
+    all_blocks.insert(head);
+    free_by_size.insert(head);
+    tree_insert(head);
 }
 
 void MemorySimulator::set_strategy(AllocationStrategy strategy){
     current_strategy = strategy;
 }
-int MemorySimulator::my_malloc(int requested_size) {
+
+// --- BLOCK POOL ---
+
+int MemorySimulator::new_block(int id, long long start, long long size, bool free, int next) {
+    int slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        blocks[slot] = Block(id, start, size, free, next);
+    } else {
+        slot = (int)blocks.size();
+        blocks.emplace_back(id, start, size, free, next);
+    }
+    priority_state ^= priority_state << 13;
+    priority_state ^= priority_state >> 17;
+    priority_state ^= priority_state << 5;
+    blocks[slot].priority = priority_state;
+    return slot;
+}
+
+void MemorySimulator::delete_block(int block) {
+    free_slots.push_back(block);
+}
+
+// --- FREE-BLOCK INDEX ---
+
+void MemorySimulator::update_max(int block) {
+    Block& b = blocks[block];
+    b.max_free = b.size;
+    if (b.left != NO_BLOCK && blocks[b.left].max_free > b.max_free) b.max_free = blocks[b.left].max_free;
+    if (b.right != NO_BLOCK && blocks[b.right].max_free > b.max_free) b.max_free = blocks[b.right].max_free;
+}
+
+// Splits a subtree into blocks starting below `start` and the rest.
+void MemorySimulator::split(int tree, long long start, int& lower, int& upper) {
+    if (tree == NO_BLOCK) {
+        lower = upper = NO_BLOCK;
+        return;
+    }
+    if (blocks[tree].start_address < start) {
+        split(blocks[tree].right, start, blocks[tree].right, upper);
+        lower = tree;
+    } else {
+        split(blocks[tree].left, start, lower, blocks[tree].left);
+        upper = tree;
+    }
+    update_max(tree);
+}
+
+// Joins two subtrees where every block in `lower` precedes every block in `upper`.
+int MemorySimulator::join(int lower, int upper) {
+    if (lower == NO_BLOCK) return upper;
+    if (upper == NO_BLOCK) return lower;
+    if (blocks[lower].priority > blocks[upper].priority) {
+        blocks[lower].right = join(blocks[lower].right, upper);
+        update_max(lower);
+        return lower;
+    }
+    blocks[upper].left = join(lower, blocks[upper].left);
+    update_max(upper);
+    return upper;
+}
+
+// Descends past higher-priority nodes (raising their max on the way), then
+// splits the remaining subtree around the new block.
+void MemorySimulator::tree_insert(int block) {
+    Block& b = blocks[block];
+    int* link = &free_root;
+    while (*link != NO_BLOCK && blocks[*link].priority > b.priority) {
+        Block& node = blocks[*link];
+        if (node.max_free < b.size) node.max_free = b.size;
+        link = (b.start_address < node.start_address) ? &node.left : &node.right;
+    }
+    split(*link, b.start_address, b.left, b.right);
+    update_max(block);
+    *link = block;
+}
+
+// Link pointing at block; its ancestors are left in tree_path.
+int* MemorySimulator::tree_link(int block) {
+    const Block& b = blocks[block];
+    tree_path.clear();
+    int* link = &free_root;
+    while (*link != block) {
+        Block& node = blocks[*link];
+        tree_path.push_back(*link);
+        link = (b.start_address < node.start_address) ? &node.left : &node.right;
+    }
+    return link;
+}
+
+// Recomputes the max of the ancestors in tree_path bottom-up until one is
+// unchanged.
+void MemorySimulator::update_path() {
+    for (auto it = tree_path.rbegin(); it != tree_path.rend(); ++it) {
+        long long old_max = blocks[*it].max_free;
+        update_max(*it);
+        if (blocks[*it].max_free == old_max) break;
+    }
+}
+
+void MemorySimulator::tree_remove(int block) {
+    int* link = tree_link(block);
+    *link = join(blocks[block].left, blocks[block].right);
+    update_path();
+}
+
+// Raises the max along the path after block grew in place.
+void MemorySimulator::tree_grow(int block) {
+    tree_link(block);
+    long long size = blocks[block].size;
+    if (blocks[block].max_free < size) blocks[block].max_free = size;
+    for (int node : tree_path) {
+        if (blocks[node].max_free < size) blocks[node].max_free = size;
+    }
+}
+
+// Puts `replacement` in block's position; it must sort between the same
+// neighbors.
+void MemorySimulator::tree_replace(int block, int replacement) {
+    int* link = tree_link(block);
+    Block& r = blocks[replacement];
+    r.left = blocks[block].left;
+    r.right = blocks[block].right;
+    r.priority = blocks[block].priority;
+    update_max(replacement);
+    *link = replacement;
+    update_path();
+}
+
+// Lowest-addressed free block that fits: descend towards the leftmost
+// subtree whose largest free block is big enough.
+int MemorySimulator::find_first_fit(long long requested_size) {
+    int node = free_root;
+    if (node == NO_BLOCK || blocks[node].max_free < requested_size) return NO_BLOCK;
+
+    while (true) {
+        const Block& b = blocks[node];
+        if (b.left != NO_BLOCK && blocks[b.left].max_free >= requested_size) {
+            node = b.left;
+        } else if (b.size >= requested_size) {
+            return node;
+        } else {
+            node = b.right;
+        }
+    }
+}
+
+// Smallest free block that fits (lowest address on ties).
+int MemorySimulator::find_best_fit(long long requested_size) {
+    blocks[PROBE].size = requested_size;
+    blocks[PROBE].start_address = LLONG_MIN;
+    auto it = free_by_size.lower_bound(PROBE);
+    return (it == free_by_size.end()) ? NO_BLOCK : *it;
+}
+
+// Largest free block (lowest address on ties), if it fits.
+int MemorySimulator::find_worst_fit(long long requested_size) {
+    if (free_by_size.empty()) return NO_BLOCK;
+    long long largest = blocks[*free_by_size.rbegin()].size;
+    if (largest < requested_size) return NO_BLOCK;
+
+    blocks[PROBE].size = largest;
+    blocks[PROBE].start_address = LLONG_MIN;
+    return *free_by_size.lower_bound(PROBE);
+}
+
+long long MemorySimulator::my_malloc(long long requested_size) {
     total_allocations++;
-    Block* best_block = nullptr;
-    Block* current = head;
+    int best_block = NO_BLOCK;
+
+    if (requested_size <= 0) {
+        failed_allocations++;
+        if (verbose) std::cout << "Allocation failed: Invalid size!\n";
+        return -1;
+    }
 
     // --- STRATEGY SELECTION LOGIC ---
-    
+    // Each strategy picks the same block a full list scan would.
+
     if (current_strategy == FIRST_FIT) {
-        // Stop at the very first match
-        while (current != nullptr) {
-            if (current->is_free && current->size >= requested_size) {
-                best_block = current;
-                break; 
-            }
-            current = current->next;
-        }
-    } 
-    
-    else if (current_strategy == BEST_FIT) {
-        // Scan ALL blocks. Find the smallest one that fits.
+        best_block = find_first_fit(requested_size);
+    } else if (current_strategy == BEST_FIT) {
         // Goal: Minimize wasted space (leftover).
-        while (current != nullptr) {
-            if (current->is_free && current->size >= requested_size) {
-                if (best_block == nullptr || current->size < best_block->size) {
-                    best_block = current;
-                }
-            }
-            current = current->next;
-        }
-    } 
-    
-    else if (current_strategy == WORST_FIT) {
-        // Scan ALL blocks. Find the largest one that fits.
+        best_block = find_best_fit(requested_size);
+    } else if (current_strategy == WORST_FIT) {
         // Goal: Leave a gap big enough to be useful later.
-        while (current != nullptr) {
-            if (current->is_free && current->size >= requested_size) {
-                if (best_block == nullptr || current->size > best_block->size) {
-                    best_block = current;
-                }
-            }
-            current = current->next;
-        }
+        best_block = find_worst_fit(requested_size);
     }
 
     // --- ALLOCATION LOGIC (Common to all) ---
 
-    if (best_block == nullptr) {
+    if (best_block == NO_BLOCK) {
         failed_allocations++;
-        std::cout << "Allocation failed: Not enough memory!\n";
+        if (verbose) std::cout << "Allocation failed: Not enough memory!\n";
         return -1;
     }
 
-    // Split the block if it's too big
-    if (best_block->size > requested_size) {
-        int remaining_size = best_block->size - requested_size;
-        int new_block_start = best_block->start_address + requested_size;
+    free_by_size.erase(best_block);
+
+    // Split the block if it's too big. The free remainder takes the chosen
+    // block's place in the address tree, since no free block lies between.
+    if (blocks[best_block].size > requested_size) {
+        long long remaining_size = blocks[best_block].size - requested_size;
+        long long new_block_start = blocks[best_block].start_address + requested_size;
 
-        Block* new_free_block = new Block(
-            -1, new_block_start, remaining_size, true, best_block->next
+        int new_free_block = new_block(
+            -1, new_block_start, remaining_size, true, blocks[best_block].next
         );
-        best_block->next = new_free_block;
+        blocks[best_block].next = new_free_block;
+        all_blocks.insert(new_free_block);
+        free_by_size.insert(new_free_block);
+        tree_replace(best_block, new_free_block);
+    } else {
+        tree_remove(best_block);
     }
 
     // Update the chosen block
-    best_block->size = requested_size;
-    best_block->is_free = false;
-    best_block->id = next_id_counter;
+    Block& chosen = blocks[best_block];
+    chosen.size = requested_size;
+    chosen.is_free = false;
+    chosen.id = next_id_counter;
     
     int allocated_id = next_id_counter;
     next_id_counter++;
     successful_allocations++;
-    std::cout << "Allocated " << best_block->size << " bytes at " << best_block->start_address << " (ID = " <<allocated_id<< ")\n";
-    return best_block->start_address;
-}
-
-void MemorySimulator::merge_free_blocks() {
-    Block* current = head;
-
-    while (current != nullptr && current->next != nullptr) {
-        if (current->is_free && current->next->is_free) {
-            
-            current->size += current->next->size;
-            
-            Block* temp = current->next;
-            current->next = current->next->next;
-            
-            delete temp;     
-        } else {
-            current = current->next;
-        }
-    }
+    if (verbose) std::cout << "Allocated " << chosen.size << " bytes at " << chosen.start_address << " (ID = " <<allocated_id<< ")\n";
+    return chosen.start_address;
 }
 
-bool MemorySimulator::is_allocated(int addr) {
-    Block* current = head;
-    while (current != nullptr) {
-        // Check if address is within this block's range
-        if (addr >= current->start_address && addr < (current->start_address + current->size)) {
-            return !current->is_free; // True if USED, False if FREE
+// Coalesces a just-freed (not yet indexed) block with its free neighbors
+// and indexes the result. Adjacent free blocks are always merged, so only
+// the two neighbors need checking. A merged block keeps its neighbor's place
+// in the address tree instead of being reinserted.
+void MemorySimulator::merge_free_blocks(int block) {
+    // Absorb the right neighbor
+    int right = blocks[block].next;
+    bool absorbed_right = false;
+    if (right != NO_BLOCK && blocks[right].is_free) {
+        free_by_size.erase(right);
+        all_blocks.erase(right);
+        blocks[block].size += blocks[right].size;
+        blocks[block].next = blocks[right].next;
+        absorbed_right = true;
+    }
+
+    // Fold into the left neighbor
+    auto it = all_blocks.find(block);
+    int left = (it == all_blocks.begin()) ? NO_BLOCK : *std::prev(it);
+    if (left != NO_BLOCK && blocks[left].is_free) {
+        if (absorbed_right) {
+            tree_remove(right);
+            delete_block(right);
         }
-        current = current->next;
+        free_by_size.erase(left);
+        all_blocks.erase(it);
+        blocks[left].size += blocks[block].size;
+        blocks[left].next = blocks[block].next;
+        delete_block(block);
+        free_by_size.insert(left);
+        tree_grow(left);
+        return;
+    }
+
+    free_by_size.insert(block);
+    if (absorbed_right) {
+        tree_replace(right, block);
+        delete_block(right);
+    } else {
+        tree_insert(block);
     }
-    return false; // Address out of bounds
 }
 
-bool MemorySimulator::my_free(int physical_address) {
-    Block* current = head;
-    bool found = false;
+// Block containing addr: the last block starting at or below it.
+int MemorySimulator::find_block(long long addr) {
+    blocks[PROBE].start_address = addr;
+    auto it = all_blocks.upper_bound(PROBE);
+    if (it == all_blocks.begin()) return NO_BLOCK;
+    int block = *std::prev(it);
+    if (addr >= blocks[block].start_address + blocks[block].size) return NO_BLOCK;
+    return block;
+}
 
-    // Search for the block starting at this specific address
-    while (current != nullptr) {
-        // We look for a USED block that starts EXACTLY at the given address
-        if (!current->is_free && current->start_address == physical_address) {
-            current->is_free = true;
-            current->id = -1; // Reset ID
-            found = true;
-            std::cout << "Block at address " << physical_address << " freed.\n";
-            break; 
-        }
-        current = current->next;
-    }
+bool MemorySimulator::is_allocated(long long addr) {
+    int block = find_block(addr);
+    if (block == NO_BLOCK) return false; // Address out of bounds
+    return !blocks[block].is_free; // True if USED, False if FREE
+}
+
+bool MemorySimulator::my_free(long long physical_address) {
+    // We look for a USED block that starts EXACTLY at the given address
+    int current = find_block(physical_address);
 
-    if (found) {
-        merge_free_blocks(); // Coalesce neighbors immediately
+    if (current != NO_BLOCK && !blocks[current].is_free &&
+        blocks[current].start_address == physical_address) {
+        blocks[current].is_free = true;
+        blocks[current].id = -1; // Reset ID
+        if (verbose) std::cout << "Block at address " << physical_address << " freed.\n";
+
+        merge_free_blocks(current); // Coalesce neighbors and index the result
         return true;
     } else {
-        std::cout << "Error: MMU tried to free invalid address " << physical_address << "\n";
+        if (verbose) std::cout << "Error: MMU tried to free invalid address " << physical_address << "\n";
         return false;
     }
 }
 // Dump Memory Implementation
 void MemorySimulator::dump_memory() {
     std::cout << "\n--- Memory Dump ---\n";
-    Block* current = head;
-    while (current != nullptr) {
-        std::cout << "[" << current->start_address << " - " 
-                  << (current->start_address + current->size - 1) << "] ";
+    for (int i = head; i != NO_BLOCK; i = blocks[i].next) {
+        const Block& current = blocks[i];
+        std::cout << "[" << current.start_address << " - " 
+                  << (current.start_address + current.size - 1) << "] ";
         
-        if (current->is_free) {
+        if (current.is_free) {
             std::cout << "FREE\n";
         } else {
-            std::cout << "USED (ID=" << current->id << ")\n";
+            std::cout << "USED (ID=" << current.id << ")\n";
         }
-        current = current->next;
     }
     std::cout << "-------------------\n";
 }
 
 void MemorySimulator::print_stats(){
-    int used_memory {};
-    int free_memory {};
-    int largest_free_block {};
-    int internal_fragmentation {};
-
-    Block* current = head;
-    while(current!= nullptr){
-        if(current->is_free) {
-            free_memory += current->size;
-            if(current->size > largest_free_block){
-                largest_free_block = current->size;
+    long long used_memory {};
+    long long free_memory {};
+    long long largest_free_block {};
+    long long internal_fragmentation {}; // Blocks are cut to the exact request size
+
+    for (int i = head; i != NO_BLOCK; i = blocks[i].next) {
+        const Block& current = blocks[i];
+        if(current.is_free) {
+            free_memory += current.size;
+            if(current.size > largest_free_block){
+                largest_free_block = current.size;
             }
         } else {
-            used_memory += current->size;
+            used_memory += current.size;
         }
-        current = current->next;
     }
 
     double ext_frag_percent = 0.0;
@@ -0,0 +1,277 @@
+#include <iomanip>
+#include <iostream>
+#include "../../include/SlabAllocator.h"
+
+SlabAllocator::SlabAllocator(long long size, int slab_bytes)
+    : total_memory_size(size), slab_size(slab_bytes), backing(size) {
+    backing.set_verbose(false);
+    if (!valid_slab_size(slab_size)) {
+        std::cout << "Error: Slab size " << slab_size << " is not a power of two of at least "
+                  << MIN_SLAB_SIZE << " bytes. Using " << DEFAULT_SLAB_SIZE << ".\n";
+        slab_size = DEFAULT_SLAB_SIZE;
+    }
+
+    // Small heaps get smaller slabs so that several fit
+    while (slab_size > 64 && slab_size > size / 4) slab_size /= 2;
+
+    // Small classes hold at least four regions per slab
+    int limit = slab_size / 4;
+    std::vector<int> classes = {8, 16, 32, 48, 64};
+    for (int base = 64; ; base *= 2) {
+        bool done = false;
+        for (int i = 1; i <= 4; i++) {
+            int c = base + i * (base / 4);
+            if (c > limit) { done = true; break; }
+            classes.push_back(c);
+        }
+        if (done) break;
+    }
+    while (classes.size() > 1 && classes.back() > limit) classes.pop_back();
+
+    for (int c : classes) {
+        Bin bin;
+        bin.region_size = c;
+        bin.nregs = slab_size / c;
+        bins.push_back(bin);
+    }
+}
+
+// --- Size Classes ---
+
+int SlabAllocator::bin_index(long long size) const {
+    // Few classes: a linear scan over a tiny vector is cheapest
+    for (size_t i = 0; i < bins.size(); i++) {
+        if (bins[i].region_size >= size) return (int)i;
+    }
+    return -1;
+}
+
+// Large classes: four per doubling, i.e. round up to a quarter of the
+// next-lower power of two.
+long long SlabAllocator::large_class(long long size) {
+    long long base = 1;
+    while (base * 2 < size) base *= 2;
+    long long step = (base >= 4) ? base / 4 : 1;
+    return (size + step - 1) / step * step;
+}
+
+// --- Allocation ---
+
+long long SlabAllocator::alloc_small(int bin_id, long long requested_size) {
+    Bin& bin = bins[bin_id];
+
+    // Lowest-addressed slab with room, or a fresh one
+    if (bin.nonfull.empty()) {
+        long long start = backing.my_malloc(slab_size);
+        if (start == -1) return -1;
+
+        Slab slab;
+        slab.start = start;
+        slab.bin = bin_id;
+        slab.nfree = bin.nregs;
+        slab.bitmap.assign((bin.nregs + 63) / 64, 0);
+        slabs[start] = slab;
+        bin.nonfull.insert(start);
+        bin.slabs++;
+        slabs_created++;
+    }
+
+    Slab& slab = slabs[*bin.nonfull.begin()];
+
+    // First free region in the bitmap
+    int region = -1;
+    for (size_t w = 0; w < slab.bitmap.size() && region == -1; w++) {
+        uint64_t word = slab.bitmap[w];
+        if (word == ~0ULL) continue;
+        for (int b = 0; b < 64; b++) {
+            if (!((word >> b) & 1)) {
+                region = (int)(w * 64 + b);
+                break;
+            }
+        }
+    }
+    slab.bitmap[region / 64] |= 1ULL << (region % 64);
+    slab.nfree--;
+    if (slab.nfree == 0) bin.nonfull.erase(slab.start);
+
+    long long addr = slab.start + (long long)region * bin.region_size;
+    requested_sizes[addr] = requested_size;
+    bin.live_regions++;
+    bin.requests++;
+    small_requested += requested_size;
+    small_allocated += bin.region_size;
+    return addr;
+}
+
+long long SlabAllocator::alloc_large(long long requested_size) {
+    long long size = large_class(requested_size);
+    long long addr = backing.my_malloc(size);
+    if (addr == -1) return -1;
+
+    large_allocs[addr] = LargeAlloc{size, requested_size};
+    large_requested += requested_size;
+    large_allocated += size;
+    return addr;
+}
+
+long long SlabAllocator::my_malloc(long long requested_size) {
+    total_allocations++;
+
+    long long addr = -1;
+    if (requested_size > 0) {
+        int bin = bin_index(requested_size);
+        addr = (bin != -1) ? alloc_small(bin, requested_size) : alloc_large(requested_size);
+    }
+
+    if (addr == -1) {
+        if (verbose) std::cout << "Allocation failed: Not enough memory!\n";
+        return -1;
+    }
+
+    successful_allocations++;
+    if (verbose) {
+        int bin = bin_index(requested_size);
+        std::cout << "Allocated " << requested_size << " bytes at " << addr;
+        if (bin != -1) std::cout << " (Class " << bins[bin].region_size << ")\n";
+        else std::cout << " (Large " << large_allocs[addr].size << ")\n";
+    }
+    return addr;
+}
+
+SlabAllocator::Slab* SlabAllocator::find_slab(long long addr) {
+    auto it = slabs.upper_bound(addr);
+    if (it == slabs.begin()) return nullptr;
+    --it;
+    if (addr >= it->first + slab_size) return nullptr;
+    return &it->second;
+}
+
+// Returns an empty slab's memory to the backing allocator
+void SlabAllocator::release_slab(Slab& slab) {
+    Bin& bin = bins[slab.bin];
+    long long start = slab.start;
+    bin.nonfull.erase(start);
+    bin.slabs--;
+    slabs.erase(start);
+    backing.my_free(start);
+    slabs_reclaimed++;
+}
+
+bool SlabAllocator::my_free(long long physical_address) {
+    Slab* slab = find_slab(physical_address);
+    if (slab != nullptr) {
+        Bin& bin = bins[slab->bin];
+        long long offset = physical_address - slab->start;
+        int region = (int)(offset / bin.region_size);
+        bool in_use = (offset % bin.region_size == 0) && region < bin.nregs &&
+                      ((slab->bitmap[region / 64] >> (region % 64)) & 1);
+        if (in_use) {
+            slab->bitmap[region / 64] &= ~(1ULL << (region % 64));
+            slab->nfree++;
+            bin.nonfull.insert(slab->start);
+            bin.live_regions--;
+            small_requested -= requested_sizes[physical_address];
+            small_allocated -= bin.region_size;
+            requested_sizes.erase(physical_address);
+
+            // Reclaim empty slabs, keeping one per bin to absorb churn
+            if (slab->nfree == bin.nregs && bin.nonfull.size() > 1) {
+                release_slab(*slab);
+            }
+            if (verbose) std::cout << "Block at address " << physical_address << " freed.\n";
+            return true;
+        }
+    } else {
+        auto it = large_allocs.find(physical_address);
+        if (it != large_allocs.end()) {
+            large_requested -= it->second.requested;
+            large_allocated -= it->second.size;
+            large_allocs.erase(it);
+            backing.my_free(physical_address);
+            if (verbose) std::cout << "Block at address " << physical_address << " freed.\n";
+            return true;
+        }
+    }
+
+    if (verbose) std::cout << "Error: MMU tried to free invalid address " << physical_address << "\n";
+    return false;
+}
+
+bool SlabAllocator::is_allocated(long long addr) {
+    Slab* slab = find_slab(addr);
+    if (slab != nullptr) {
+        const Bin& bin = bins[slab->bin];
+        int region = (int)((addr - slab->start) / bin.region_size);
+        if (region >= bin.nregs) return false; // Slab tail
+        return (slab->bitmap[region / 64] >> (region % 64)) & 1;
+    }
+
+    auto it = large_allocs.upper_bound(addr);
+    if (it == large_allocs.begin()) return false;
+    --it;
+    return addr < it->first + it->second.size;
+}
+
+// --- Reporting ---
+
+void SlabAllocator::dump_memory() {
+    std::cout << "\n--- Slab Bins ---\n";
+    std::cout << " Class | Regs/Slab | Slabs | Live Regions | Utilization\n";
+    for (const Bin& bin : bins) {
+        if (bin.slabs == 0) continue;
+        long long capacity = (long long)bin.slabs * bin.nregs;
+        std::cout << std::setw(6) << bin.region_size << " | "
+                  << std::setw(9) << bin.nregs << " | "
+                  << std::setw(5) << bin.slabs << " | "
+                  << std::setw(12) << bin.live_regions << " | "
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << (double)bin.live_regions / capacity * 100.0 << "%\n";
+    }
+    std::cout << "Large allocations: " << large_allocs.size() << "\n";
+    for (const auto& [addr, large] : large_allocs) {
+        std::cout << "[" << addr << " - " << addr + large.size - 1 << "] LARGE ("
+                  << large.requested << "/" << large.size << " bytes)\n";
+    }
+    std::cout << "-----------------\n";
+}
+
+void SlabAllocator::print_stats() {
+    long long slab_bytes = 0, slab_tail = 0, slab_free = 0;
+    for (const auto& [start, slab] : slabs) {
+        const Bin& bin = bins[slab.bin];
+        slab_bytes += slab_size;
+        slab_tail += slab_size - (long long)bin.nregs * bin.region_size;
+        slab_free += (long long)slab.nfree * bin.region_size;
+    }
+
+    long long requested = small_requested + large_requested;
+    long long allocated = small_allocated + large_allocated;
+    long long internal_fragmentation = allocated - requested;
+    long long reserved = slab_bytes + large_allocated;
+
+    std::cout << "\n--- Statistics (Slab) ---\n";
+    std::cout << "Total Memory:       " << total_memory_size << "\n";
+    std::cout << "Slab Size:          " << slab_size << " (" << bins.size()
+              << " classes up to " << small_limit() << " bytes)\n";
+    std::cout << "Reserved Memory:    " << reserved;
+    if (total_memory_size > 0) {
+        std::cout << " (" << ((double)reserved / total_memory_size) * 100 << "%)";
+    }
+    std::cout << "\n";
+    std::cout << "Requested Memory:   " << requested << "\n";
+    std::cout << "Total Requests:     " << total_allocations << "\n";
+    std::cout << "Success Rate:       " << successful_allocations << "/"
+              << total_allocations << "\n";
+    std::cout << "Internal Frag:      " << internal_fragmentation;
+    if (allocated > 0) {
+        std::cout << " (" << (double)internal_fragmentation / allocated * 100 << "%)";
+    }
+    std::cout << "\n";
+    std::cout << "  Small / Large:    " << small_allocated - small_requested << " / "
+              << large_allocated - large_requested << "\n";
+    std::cout << "Slab Free Regions:  " << slab_free << "\n";
+    std::cout << "Slab Tail Waste:    " << slab_tail << "\n";
+    std::cout << "Slabs Live:         " << slabs.size() << " (" << slabs_created
+              << " created, " << slabs_reclaimed << " reclaimed)\n";
+    std::cout << "-------------------------\n";
+}
@@ -1,214 +1,420 @@
 #include "../../include/Cache.h"
-#include "../../include/MemoryManager.h"
+#include "../../include/Allocator.h"
+#include "../../include/Prefetcher.h"
+#include <cctype>
 #include <iomanip>
 
 // --- CacheLevel Implementation ---
 
-CacheLevel::CacheLevel(int id, size_t s, size_t bs, int assoc) {
-  level_id = id;
-  size = s;
-  block_size = bs;
-  associativity = assoc;
-
-  num_sets = size / (block_size * associativity);
-  offset_bits = std::log2(block_size);
-  index_bits = std::log2(num_sets);
-
-  // Initialize Storage
-  sets.resize(num_sets);
-  for (int i = 0; i < num_sets; i++) {
-    sets[i].resize(associativity);
+void CacheLevel::print_stats() {
+  std::cout << name << " Stats: ";
+  std::cout << "Hits: " << hits << ", Misses: " << misses;
+  if (hits + misses > 0) {
+    double ratio = (double)hits / (hits + misses) * 100.0;
+    std::cout << ", Hit Rate: " << std::fixed << std::setprecision(2) << ratio
+              << "%";
   }
+  if (write_traffic > 0)
+    std::cout << ", Dirty Evictions: " << dirty_evictions
+              << ", Write Traffic: " << write_traffic << " bytes";
+  if (back_invalidations > 0)
+    std::cout << ", Back-Invalidations: " << back_invalidations;
+  std::cout << "\n";
 }
 
-unsigned long long CacheLevel::get_index(unsigned long long addr) {
-  // Shift out offset, mask to get index
-  return (addr >> offset_bits) & (num_sets - 1);
+void CacheLevel::merge_stats(const CacheLevel &other) {
+  hits += other.hits;
+  misses += other.misses;
+  dirty_evictions += other.dirty_evictions;
+  write_traffic += other.write_traffic;
+  back_invalidations += other.back_invalidations;
+  cycles += other.cycles;
 }
 
-unsigned long long CacheLevel::get_tag(unsigned long long addr) {
-  // Shift out offset and index
-  return addr >> (offset_bits + index_bits);
+// --- CacheController Implementation ---
+
+CacheController::CacheController(CacheLevel *l1, CacheLevel *l2, Allocator *sm)
+    : std_mem(sm) {
+  levels.push_back(l1);
+  if (l2)
+    levels.push_back(l2);
 }
 
-bool CacheLevel::access(unsigned long long address, bool is_write) {
-  access_counter++; // Increment "time"
+CacheController::CacheController(const std::vector<CacheLevel *> &data_levels,
+                                 CacheLevel *l1i, Allocator *sm)
+    : levels(data_levels), icache(l1i), std_mem(sm) {
+  if (icache) {
+    ipath = levels;
+    ipath[0] = icache;
+  }
+}
 
-  unsigned long long index = get_index(address);
-  unsigned long long tag = get_tag(address);
+CacheController::~CacheController() {
+  for (CacheLevel *level : levels)
+    delete level;
+  delete icache;
+  for (PrefetchState *state : prefetch) {
+    if (state)
+      delete state->prefetcher;
+    delete state;
+  }
+}
 
-  // 1. Search the Set for the Tag
-  for (int i = 0; i < associativity; i++) {
-    if (sets[index][i].valid && sets[index][i].tag == tag) {
-      // HIT!
-      hits++;
-      sets[index][i].last_access_time = access_counter; // Update LRU
-      return true;
-    }
+std::vector<CacheLevel *> CacheController::get_levels() const {
+  std::vector<CacheLevel *> all;
+  if (icache)
+    all.push_back(icache);
+  all.insert(all.end(), levels.begin(), levels.end());
+  return all;
+}
+
+static bool same_name(const std::string &a, const std::string &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i]))
+      return false;
   }
+  return true;
+}
 
-  // 2. MISS! We need to allocate a line.
-  misses++;
+CacheLevel *CacheController::find_level(const std::string &name) const {
+  for (CacheLevel *level : get_levels()) {
+    if (same_name(level->get_name(), name))
+      return level;
+  }
+  return nullptr;
+}
 
-  // Find a victim (Invalid line OR Least Recently Used)
-  int victim_way = -1;
-  unsigned long long min_time = -1; // Max Value
+void CacheController::write_down(const Path &path, size_t from,
+                                 unsigned long long address, long long bytes) {
+  for (size_t j = from; j < path.size(); j++) {
+    if (path[j]->absorb_write(address) && path[j]->is_write_back())
+      return; // Held dirty here
+    path[j]->add_write_traffic(bytes);
+  }
+  memory_write_bytes += bytes;
+}
 
-  // First pass: Check for empty slots
-  for (int i = 0; i < associativity; i++) {
-    if (!sets[index][i].valid) {
-      victim_way = i;
-      break;
-    }
+bool CacheController::back_invalidate(size_t level,
+                                      unsigned long long address) {
+  bool dirty = false;
+  long long removed = 0;
+  for (size_t k = 0; k < level; k++) {
+    CacheEviction dropped = levels[k]->invalidate(address);
+    removed += dropped.valid;
+    dirty |= dropped.dirty;
+    if (dropped.valid)
+      forget_prefetch(levels, k, dropped.address);
+  }
+  if (icache) {
+    CacheEviction dropped = icache->invalidate(address);
+    removed += dropped.valid;
+    dirty |= dropped.dirty;
   }
+  levels[level]->add_back_invalidations(removed);
+  return dirty;
+}
 
-  // Second pass: If full, find LRU
-  if (victim_way == -1) {
-    for (int i = 0; i < associativity; i++) {
-      if (sets[index][i].last_access_time < min_time) {
-        min_time = sets[index][i].last_access_time;
-        victim_way = i;
-      }
-    }
+void CacheController::fill(const Path &path, size_t level,
+                           unsigned long long address) {
+  CacheEviction evicted = path[level]->allocate(address);
+  if (!evicted.valid)
+    return;
+  forget_prefetch(path, level, evicted.address);
+
+  long long block = path[level]->get_block_size();
+  bool dirty = evicted.dirty;
+  if (level > 0 && path[level]->get_inclusion() == INCLUSION_INCLUSIVE &&
+      back_invalidate(level, evicted.address) && !dirty) {
+    // A newer copy above goes down with the victim
+    dirty = true;
+    path[level]->add_write_traffic(block);
   }
 
-  // Replace
-  sets[index][victim_way].valid = true;
-  sets[index][victim_way].tag = tag;
-  sets[index][victim_way].last_access_time = access_counter;
+  // An exclusive level below is filled with every victim
+  if (level + 1 < path.size() &&
+      path[level + 1]->get_inclusion() == INCLUSION_EXCLUSIVE)
+    fill(path, level + 1, evicted.address);
+  if (dirty)
+    write_down(path, level + 1, evicted.address, block);
+}
 
-  return false; // Return false to signal a MISS (so we can check L2)
+// Whether path[j] takes a demand fill for this access
+static bool takes_fill(const CacheLevel *level, size_t j, bool is_write) {
+  if (is_write && !level->is_write_allocate())
+    return false;
+  // Exclusive levels are only filled with victims from above
+  return j == 0 || level->get_inclusion() != INCLUSION_EXCLUSIVE;
 }
 
-// Lookup only - checks if address is in cache, updates LRU on hit
-bool CacheLevel::lookup(unsigned long long address) {
-  access_counter++; // Increment "time"
+long long CacheController::access(unsigned long long address, bool is_write,
+                                  bool is_ifetch, unsigned long long pc) {
+  clock++;
+  long long cycles = access_path((is_ifetch && icache) ? ipath : levels,
+                                 address, is_write, false, pc);
+  latency.record(cycles);
+  return cycles;
+}
 
-  unsigned long long index = get_index(address);
-  unsigned long long tag = get_tag(address);
+long long CacheController::access_page_table(unsigned long long address) {
+  walk_accesses++;
+  long long cycles = access_path(levels, address, false, true);
+  walk_cycles += cycles;
+  return cycles;
+}
 
-  // Search the Set for the Tag
-  for (int i = 0; i < associativity; i++) {
-    if (sets[index][i].valid && sets[index][i].tag == tag) {
-      // HIT!
-      hits++;
-      sets[index][i].last_access_time = access_counter; // Update LRU
-      return true;
+long long CacheController::access_path(const Path &path,
+                                       unsigned long long address,
+                                       bool is_write, bool page_walk,
+                                       unsigned long long pc) {
+  bool log = verbose && !page_walk; // Walk reads are not echoed
+
+  // 1. Probe each level in turn (lookup only, don't allocate yet)
+  size_t hit_level = path.size();
+  long long cycles = 0;
+  for (size_t i = 0; i < path.size(); i++) {
+    cycles += path[i]->get_latency();
+    path[i]->add_cycles(path[i]->get_latency());
+    if (path[i]->lookup(address)) {
+      hit_level = i;
+      break;
     }
   }
 
-  // MISS - but don't allocate, just record the miss
-  misses++;
-  return false;
-}
+  if (hit_level < path.size()) {
+    if (log)
+      std::cout << "--- " << path[hit_level]->get_name() << " HIT ---\n";
+  } else {
+    // 2. CACHE MISS on all levels! Access Main Memory.
+    if (log)
+      std::cout << "--- CACHE MISS! Accessing Main Memory at " << address
+                << " ---\n";
 
-// Allocate a line in the cache (called only for valid memory fetches)
-void CacheLevel::allocate(unsigned long long address, bool is_write) {
-  unsigned long long index = get_index(address);
-  unsigned long long tag = get_tag(address);
+    bool valid_access = page_walk; // Page tables are always backed
 
-  // First check if already in cache (shouldn't happen, but be safe)
-  for (int i = 0; i < associativity; i++) {
-    if (sets[index][i].valid && sets[index][i].tag == tag) {
-      sets[index][i].last_access_time = access_counter;
-      return; // Already present
+    if (std_mem && !page_walk) {
+      valid_access = std_mem->is_allocated(address);
     }
-  }
 
-  // Find a victim (Invalid line OR Least Recently Used)
-  int victim_way = -1;
-  unsigned long long min_time = -1; // Max Value
-
-  // First pass: Check for empty slots
-  for (int i = 0; i < associativity; i++) {
-    if (!sets[index][i].valid) {
-      victim_way = i;
-      break;
+    if (!valid_access) {
+      invalid_accesses++;
+      if (log)
+        std::cout
+            << ">> SEGMENTATION FAULT: Attempted to access unallocated memory!\n";
+      // Do NOT cache invalid memory addresses
+      return cycles;
     }
+    if (log)
+      std::cout << ">> Main Memory: Fetching data from valid block.\n";
+    memory_fetches++;
+    memory_cycles += memory_latency;
+    cycles += memory_latency;
   }
 
-  // Second pass: If full, find LRU
-  if (victim_way == -1) {
-    for (int i = 0; i < associativity; i++) {
-      if (sets[index][i].last_access_time < min_time) {
-        min_time = sets[index][i].last_access_time;
-        victim_way = i;
+  // A first demand hit on a prefetched line makes that prefetch useful
+  bool prefetch_hit = false;
+  PrefetchState *hit_state =
+      (page_walk || hit_level == path.size()) ? nullptr
+                                              : prefetch_at(path, hit_level);
+  if (hit_state) {
+    unsigned long long block =
+        address & ~(path[hit_level]->get_block_size() - 1);
+    auto it = hit_state->pending.find(block);
+    if (it != hit_state->pending.end()) {
+      prefetch_hit = true;
+      hit_state->useful++;
+      if (clock < it->second.arrival) {
+        hit_state->late++;
+        long long wait = it->second.cycles *
+                         (long long)(it->second.arrival - clock) /
+                         hit_state->latency;
+        late_prefetch_cycles += wait;
+        cycles += wait;
       }
+      hit_state->pending.erase(it);
     }
   }
 
-  // Replace
-  sets[index][victim_way].valid = true;
-  sets[index][victim_way].tag = tag;
-  sets[index][victim_way].last_access_time = access_counter;
+  // 3-4. Fill the levels above the hit (or all of them on a miss)
+  bring_up(path, hit_level, 0, address, is_write);
+
+  // 5. The store itself
+  if (is_write)
+    write_down(path, 0, address, CacheLevel::STORE_BYTES);
+
+  // 6. Prefetchers at the levels this access reached
+  if (prefetch.empty() || page_walk)
+    return cycles;
+  for (size_t j = 0; j <= hit_level && j < path.size(); j++) {
+    PrefetchState *state = prefetch_at(path, j);
+    if (!state)
+      continue;
+    candidates.clear();
+    state->prefetcher->observe(address, pc, j < hit_level,
+                               j == hit_level && prefetch_hit, candidates);
+    if (!candidates.empty())
+      issue_prefetches(path, j, address);
+  }
+  return cycles;
 }
 
-void CacheLevel::print_stats() {
-  std::cout << "L" << level_id << " Stats: ";
-  std::cout << "Hits: " << hits << ", Misses: " << misses;
-  if (hits + misses > 0) {
-    double ratio = (double)hits / (hits + misses) * 100.0;
-    std::cout << ", Hit Rate: " << std::fixed << std::setprecision(2) << ratio
-              << "%";
+void CacheController::bring_up(const Path &path, size_t src, size_t top,
+                               unsigned long long address, bool is_write) {
+  // A hit in an exclusive level moves the line up (if anything above
+  // takes it); a dirty line stays dirty in the nearest level that does.
+  size_t nearest = src;
+  for (size_t j = src; j-- > top;) {
+    if (takes_fill(path[j], j, is_write)) {
+      nearest = j;
+      break;
+    }
   }
-  std::cout << "\n";
+  bool moved_dirty = false;
+  if (src > 0 && src < path.size() && nearest < src &&
+      path[src]->get_inclusion() == INCLUSION_EXCLUSIVE)
+    moved_dirty = path[src]->invalidate(address).dirty;
+
+  // Fill the levels above the source, bottom up
+  for (size_t j = src; j-- > top;) {
+    if (takes_fill(path[j], j, is_write))
+      fill(path, j, address);
+  }
+  if (moved_dirty)
+    write_down(path, nearest, address, path[nearest]->get_block_size());
 }
 
-// --- CacheController Implementation ---
-
-CacheController::CacheController(CacheLevel *l1, CacheLevel *l2, MemorySimulator *sm)
-    : L1(l1), L2(l2), std_mem(sm) {}
+// --- Prefetching ---
 
-CacheController::~CacheController() {
-  delete L1;
-  if (L2)
-    delete L2;
+CacheController::PrefetchState *
+CacheController::prefetch_at(const Path &path, size_t j) const {
+  if (prefetch.empty() || (j == 0 && &path == &ipath))
+    return nullptr; // No prefetchers, or the L1I
+  return prefetch[j];
 }
 
-void CacheController::access(unsigned long long address, std::string type) {
-  bool is_write = (type == "write");
-
-  // 1. Check L1 (only lookup, don't allocate yet)
-  if (L1->lookup(address)) {
-    std::cout << "--- L1 HIT ---" << std::endl;
-    return;
-  }
+void CacheController::forget_prefetch(const Path &path, size_t j,
+                                      unsigned long long block) {
+  PrefetchState *state = prefetch_at(path, j);
+  if (state && state->pending.erase(block))
+    state->useless++;
+}
 
-  // 2. Check L2 (only lookup, don't allocate yet)
-  if (L2 && L2->lookup(address)) {
-    std::cout << "--- L2 HIT ---" << std::endl;
-    // Promote to L1 on L2 hit
-    L1->allocate(address, is_write);
-    return;
+void CacheController::issue_prefetches(const Path &path, size_t level,
+                                       unsigned long long address) {
+  PrefetchState &state = *prefetch[level];
+  for (unsigned long long target : candidates) {
+    // Prefetchers don't cross pages or fetch what the level already has
+    if ((target >> 12) != (address >> 12) || path[level]->contains(target))
+      continue;
+    if (std_mem && !std_mem->is_allocated(target))
+      continue;
+    size_t src = level + 1;
+    while (src < path.size() && !path[src]->contains(target))
+      src++;
+    bring_up(path, src, level, target, false);
+    long long fill = (src == path.size()) ? memory_latency : 0;
+    for (size_t k = level + 1; k <= src && k < path.size(); k++)
+      fill += path[k]->get_latency();
+    state.pending[target] = {clock + state.latency, fill};
+    state.issued++;
   }
+}
 
-  // 3. CACHE MISS on all levels! Access Main Memory.
-  std::cout << "--- CACHE MISS! Accessing Main Memory at " << address
-            << " ---\n";
-
-  bool valid_access = false;
-
-  if (std_mem) {
-    valid_access = std_mem->is_allocated(address);
+bool CacheController::set_prefetcher(const std::string &level, Prefetcher *p,
+                                     int latency) {
+  CacheLevel *target = find_level(level);
+  size_t j = 0;
+  while (j < levels.size() && levels[j] != target)
+    j++;
+  if (j == levels.size() || (j > 0 && target->get_inclusion() ==
+                                          INCLUSION_EXCLUSIVE)) {
+    std::cout << "Error: '" << level
+              << "' is not a data cache level that takes fills.\n";
+    delete p;
+    return false;
   }
-
-  if (valid_access) {
-    std::cout << ">> Main Memory: Fetching data from valid block.\n";
-    // Only cache valid memory accesses
-    if (L2)
-      L2->allocate(address, is_write);
-    L1->allocate(address, is_write);
-  } else {
-    std::cout
-        << ">> SEGMENTATION FAULT: Attempted to access unallocated memory!\n";
-    // Do NOT cache invalid memory addresses
+  if (prefetch.empty())
+    prefetch.assign(levels.size(), nullptr);
+  if (prefetch[j])
+    delete prefetch[j]->prefetcher;
+  delete prefetch[j];
+  prefetch[j] = nullptr;
+  if (p) {
+    prefetch[j] = new PrefetchState();
+    prefetch[j]->prefetcher = p;
+    prefetch[j]->latency = latency;
   }
+  return true;
 }
 
 void CacheController::dump_stats() {
   std::cout << "--- Cache Statistics ---\n";
-  L1->print_stats();
-  if (L2)
-    L2->print_stats();
+  for (CacheLevel *level : get_levels())
+    level->print_stats();
+  for (size_t j = 0; j < prefetch.size(); j++) {
+    const PrefetchState *state = prefetch[j];
+    if (!state)
+      continue;
+    long long misses = levels[j]->get_misses();
+    std::cout << levels[j]->get_name()
+              << " Prefetcher: " << state->prefetcher->name() << " (degree "
+              << state->prefetcher->get_degree() << ", latency "
+              << state->latency << "), Issued: " << state->issued
+              << ", Useful: " << state->useful << ", Late: " << state->late
+              << ", Useless: " << state->useless;
+    std::cout << std::fixed << std::setprecision(2);
+    if (state->issued > 0)
+      std::cout << ", Accuracy: "
+                << (double)state->useful / state->issued * 100.0 << "%";
+    if (state->useful + misses > 0)
+      std::cout << ", Coverage: "
+                << (double)state->useful / (state->useful + misses) * 100.0
+                << "%";
+    if (state->useful > 0)
+      std::cout << ", Lateness: "
+                << (double)state->late / state->useful * 100.0 << "%";
+    std::cout << "\n";
+  }
+  if (memory_write_bytes > 0)
+    std::cout << "Memory Write Traffic: " << memory_write_bytes << " bytes\n";
+  if (walk_accesses > 0)
+    std::cout << "Page Walk Accesses: " << walk_accesses << "\n";
+  if (invalid_accesses > 0)
+    std::cout << "Invalid Accesses: " << invalid_accesses << "\n";
   std::cout << "------------------------\n";
-}
\ No newline at end of file
+}
+
+void CacheController::print_latency(bool histogram) {
+  std::cout << "--- Cache Latency ---\n";
+  if (histogram)
+    latency.print();
+
+  // Every lookup a level served, page-walk reads included, at the latency
+  // in effect when it happened
+  std::vector<CacheLevel *> all = get_levels();
+  unsigned long long total = memory_cycles + late_prefetch_cycles;
+  for (CacheLevel *level : all)
+    total += level->get_cycles();
+  auto share = [&](unsigned long long cycles) {
+    return total ? (double)cycles / total * 100.0 : 0.0;
+  };
+  std::cout << std::fixed << std::setprecision(2);
+  for (CacheLevel *level : all) {
+    long long lookups = level->get_hits() + level->get_misses();
+    std::cout << std::left << std::setw(20) << (level->get_name() + ":")
+              << std::right << level->get_cycles() << " cycles in " << lookups
+              << " lookups (" << share(level->get_cycles()) << "%) ["
+              << level->get_latency() << " per lookup]\n";
+  }
+  std::cout << "Memory:             " << memory_cycles << " cycles in "
+            << memory_fetches << " fetches (" << share(memory_cycles)
+            << "%) [" << memory_latency << " per fetch]\n";
+  if (late_prefetch_cycles > 0)
+    std::cout << "Late Prefetches:    " << late_prefetch_cycles
+              << " cycles (" << share(late_prefetch_cycles) << "%)\n";
+  if (walk_accesses > 0)
+    std::cout << "Page Walk Reads:    " << walk_cycles << " cycles of the above ("
+              << walk_accesses << " reads)\n";
+  std::cout << "---------------------\n";
+}
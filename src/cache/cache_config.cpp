@@ -0,0 +1,228 @@
+#include "../../include/Cache.h"
+#include "../../include/Trace.h"
+#include <cctype>
+#include <climits>
+#include <fstream>
+#include <sstream>
+
+// --- Hierarchy Config Files ---
+
+// Parses "32768", "0x8000", "32K", "8M" or "1G" (numbers as in parse_number)
+static bool parse_size(const std::string &token, size_t &value) {
+  const char *end;
+  uint64_t n;
+  if (!parse_number(token.c_str(), end, n))
+    return false;
+  int shift = 0;
+  if (*end != '\0') {
+    char unit = std::toupper((unsigned char)*end);
+    if (end[1] != '\0')
+      return false;
+    if (unit == 'K')
+      shift = 10;
+    else if (unit == 'M')
+      shift = 20;
+    else if (unit == 'G')
+      shift = 30;
+    else
+      return false;
+  }
+  if (n > ((uint64_t)LLONG_MAX >> shift)) {
+    std::cout << "Error: '" << token << "' is too large.\n";
+    return false;
+  }
+  value = (size_t)(n << shift);
+  return true;
+}
+
+static bool is_pow2(unsigned long long n) { return n && !(n & (n - 1)); }
+
+struct LevelSpec {
+  std::string name;
+  size_t size = 0;
+  size_t block_size = 0;
+  int assoc = 0;
+  std::string policy = "lru";
+  CacheInclusion inclusion = INCLUSION_NINE;
+  bool inclusion_set = false;
+  bool write_back = true;
+  bool write_allocate = true;
+  int latency = -1; // Cycles per lookup; -1 = the level's default
+};
+
+// Reads one level line; prints the problem and returns false if invalid
+static bool parse_level(std::istringstream &line, LevelSpec &spec,
+                        int line_no) {
+  std::string size_tok, block_tok, assoc_tok, option;
+  line >> spec.name >> size_tok >> block_tok >> assoc_tok;
+  size_t assoc = 0;
+  if (!parse_size(size_tok, spec.size) ||
+      !parse_size(block_tok, spec.block_size) || !parse_size(assoc_tok, assoc)) {
+    std::cout << "Error: line " << line_no
+              << ": expected <name> <size> <block> <assoc>.\n";
+    return false;
+  }
+  if (assoc > INT_MAX) {
+    std::cout << "Error: line " << line_no << ": associativity " << assoc
+              << " is too large.\n";
+    return false;
+  }
+  spec.assoc = (int)assoc;
+  for (char &c : spec.name)
+    c = std::toupper((unsigned char)c);
+
+  while (line >> option) {
+    size_t eq = option.find('=');
+    std::string key = option.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : option.substr(eq + 1);
+    if (key == "policy") {
+      spec.policy = value;
+    } else if (key == "inclusion" && value == "nine") {
+      spec.inclusion = INCLUSION_NINE;
+      spec.inclusion_set = true;
+    } else if (key == "inclusion" && value == "inclusive") {
+      spec.inclusion = INCLUSION_INCLUSIVE;
+      spec.inclusion_set = true;
+    } else if (key == "inclusion" && value == "exclusive") {
+      spec.inclusion = INCLUSION_EXCLUSIVE;
+      spec.inclusion_set = true;
+    } else if (key == "write" &&
+               (value == "write-back" || value == "write-through")) {
+      spec.write_back = value == "write-back";
+    } else if (key == "latency" && !value.empty() && value.size() <= 9 &&
+               value.find_first_not_of("0123456789") == std::string::npos) {
+      spec.latency = std::stoi(value);
+    } else if (key == "alloc" &&
+               (value == "write-allocate" || value == "no-write-allocate")) {
+      spec.write_allocate = value == "write-allocate";
+    } else {
+      std::cout << "Error: line " << line_no << ": unknown option '" << option
+                << "'.\n";
+      return false;
+    }
+  }
+
+  if (!is_pow2(spec.block_size) || spec.assoc < 1 ||
+      spec.size % (spec.block_size * spec.assoc) != 0 ||
+      !is_pow2(spec.size / (spec.block_size * spec.assoc))) {
+    std::cout << "Error: line " << line_no << ": " << spec.name
+              << " needs a power-of-two block size and set count.\n";
+    return false;
+  }
+  return true;
+}
+
+// Checks names and ordering: optional L1I, then L1 (or L1D), L2, L3, ...
+static bool check_levels(const std::vector<LevelSpec> &data,
+                         const LevelSpec *l1i) {
+  if (data.empty()) {
+    std::cout << "Error: the hierarchy needs an L1 (or L1D) level.\n";
+    return false;
+  }
+  for (size_t i = 0; i < data.size(); i++) {
+    std::string expected = "L" + std::to_string(i + 1);
+    bool ok = data[i].name == expected ||
+              (i == 0 && data[i].name == "L1D");
+    if (!ok) {
+      std::cout << "Error: level " << data[i].name << " found where "
+                << expected << " was expected.\n";
+      return false;
+    }
+    if (data[i].block_size != data[0].block_size) {
+      std::cout << "Error: all levels must share one block size.\n";
+      return false;
+    }
+  }
+  if (l1i && l1i->block_size != data[0].block_size) {
+    std::cout << "Error: all levels must share one block size.\n";
+    return false;
+  }
+  if (data[0].inclusion_set || (l1i && l1i->inclusion_set)) {
+    std::cout << "Error: inclusion applies to levels below L1.\n";
+    return false;
+  }
+  return true;
+}
+
+static CacheLevel *build_level(const LevelSpec &spec, int id) {
+  CacheLevel *level = create_cache_level(id, spec.size, spec.block_size,
+                                         spec.assoc, spec.policy);
+  if (!level)
+    return nullptr;
+  level->set_name(spec.name);
+  level->set_write_policy(spec.write_back, spec.write_allocate);
+  level->set_inclusion(spec.inclusion);
+  if (spec.latency >= 0)
+    level->set_latency(spec.latency);
+  return level;
+}
+
+CacheController *load_cache_config(const std::string &path, Allocator *sm,
+                                   bool verbose) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cout << "Error: Cannot open cache config '" << path << "'.\n";
+    return nullptr;
+  }
+
+  std::vector<LevelSpec> data;
+  LevelSpec icache_spec;
+  bool has_icache = false;
+  std::string text;
+  int line_no = 0;
+  while (std::getline(file, text)) {
+    line_no++;
+    size_t hash = text.find('#');
+    if (hash != std::string::npos)
+      text.erase(hash);
+    std::istringstream line(text);
+    std::string first;
+    if (!(line >> first))
+      continue; // Blank or comment
+    line.seekg(0);
+
+    LevelSpec spec;
+    if (!parse_level(line, spec, line_no))
+      return nullptr;
+    if (spec.name == "L1I") {
+      if (has_icache) {
+        std::cout << "Error: line " << line_no << ": duplicate L1I.\n";
+        return nullptr;
+      }
+      icache_spec = spec;
+      has_icache = true;
+    } else {
+      data.push_back(spec);
+    }
+  }
+  if (!check_levels(data, has_icache ? &icache_spec : nullptr))
+    return nullptr;
+
+  // A split L1 names its data side L1D
+  if (has_icache)
+    data[0].name = "L1D";
+
+  std::vector<CacheLevel *> levels;
+  CacheLevel *icache = nullptr;
+  bool ok = true;
+  for (size_t i = 0; i < data.size() && ok; i++) {
+    CacheLevel *level = build_level(data[i], (int)i + 1);
+    if (level)
+      levels.push_back(level);
+    else
+      ok = false;
+  }
+  if (ok && has_icache) {
+    icache = build_level(icache_spec, 1);
+    ok = icache != nullptr;
+  }
+  if (!ok) {
+    for (CacheLevel *level : levels)
+      delete level;
+    return nullptr;
+  }
+
+  CacheController *controller = new CacheController(levels, icache, sm);
+  controller->set_verbose(verbose);
+  return controller;
+}
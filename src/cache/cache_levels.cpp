@@ -0,0 +1,94 @@
+#include "../../include/CacheLevelImpl.h"
+#include <climits>
+#include <iostream>
+#include <type_traits>
+
+// --- Specialized Levels ---
+// Common geometries are instantiated for every policy class; anything else
+// (or specialize = false) gets the runtime level.
+
+template <int Sets, int Ways, int BlockSize>
+static CacheLevel *make_static(int id, const std::string &policy) {
+  size_t size = (size_t)Sets * Ways * BlockSize;
+  auto build = [&](auto *repl) -> CacheLevel * {
+    using P = std::remove_pointer_t<decltype(repl)>;
+    return new StaticCacheLevel<Sets, Ways, BlockSize, P>(id, size, BlockSize,
+                                                          Ways, repl);
+  };
+
+  if (policy == "lru")
+    return build(new LRUPolicy(Sets, Ways));
+  if (policy == "fifo")
+    return build(new FIFOPolicy(Sets, Ways));
+  if (policy == "random")
+    return build(new RandomPolicy(Sets, Ways));
+  if (policy == "bit-plru")
+    return build(new BitPLRUPolicy(Sets, Ways));
+  if (policy == "srrip" || policy == "brrip")
+    return build(new RRIPPolicy(Sets, Ways, policy == "brrip"));
+  if constexpr ((Ways & (Ways - 1)) == 0) {
+    if (policy == "tree-plru" || policy == "plru")
+      return build(new TreePLRUPolicy(Sets, Ways));
+  }
+  return nullptr;
+}
+
+struct StaticGeometry {
+  size_t size;
+  size_t block_size;
+  int assoc;
+  CacheLevel *(*make)(int id, const std::string &policy);
+};
+
+#define CACHE_GEOMETRY(SIZE, WAYS, BLOCK)                                      \
+  {SIZE, BLOCK, WAYS, &make_static<(SIZE) / ((WAYS) * (BLOCK)), WAYS, BLOCK>}
+
+// L1s, their 8x L2s (as built by init_cache) and typical L2/LLC sizes
+static const StaticGeometry static_geometries[] = {
+    CACHE_GEOMETRY(32 * 1024, 8, 64),        // L1D
+    CACHE_GEOMETRY(48 * 1024, 12, 64),       // L1D (12-way)
+    CACHE_GEOMETRY(256 * 1024, 8, 64),       // 8x a 32K L1
+    CACHE_GEOMETRY(384 * 1024, 12, 64),      // 8x a 48K L1
+    CACHE_GEOMETRY(256 * 1024, 16, 64),      // L2
+    CACHE_GEOMETRY(1024 * 1024, 16, 64),     // L2
+    CACHE_GEOMETRY(2048 * 1024, 16, 64),     // L2 / LLC slice
+    CACHE_GEOMETRY(8192 * 1024, 16, 64),     // LLC
+    CACHE_GEOMETRY(32 * 1024 * 1024, 32, 64) // Large LLC
+};
+
+#undef CACHE_GEOMETRY
+
+// --- Factory ---
+
+CacheLevel *create_cache_level(int id, size_t size, size_t block_size,
+                               int assoc, const std::string &policy,
+                               bool specialize) {
+  // Same rules as hierarchy config files: a power-of-two block size and a
+  // power-of-two number of sets that exactly divides the size
+  size_t sets =
+      (assoc > 0 && block_size > 0) ? size / (block_size * assoc) : 0;
+  if (block_size == 0 || (block_size & (block_size - 1)) != 0 || sets == 0 ||
+      sets * block_size * assoc != size || (sets & (sets - 1)) != 0 ||
+      sets > INT_MAX) {
+    std::cout << "Error: L" << id
+              << " needs a power-of-two block size and set count.\n";
+    return nullptr;
+  }
+
+  if (specialize) {
+    for (const StaticGeometry &g : static_geometries) {
+      if (g.size == size && g.block_size == block_size && g.assoc == assoc) {
+        CacheLevel *level = g.make(id, policy);
+        if (level)
+          return level;
+        break; // Policy not specialized here; validate it below
+      }
+    }
+  }
+
+  ReplacementPolicy *repl =
+      create_replacement_policy(policy, (int)sets, assoc);
+  if (!repl)
+    return nullptr;
+  return new DynamicCacheLevel(id, size, block_size, assoc, repl);
+}
@@ -0,0 +1,43 @@
+#include "../../include/Latency.h"
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Largest latency in bucket b
+static unsigned long long bucket_max(int b) {
+  return b == 0 ? 0 : (1ULL << b) - 1;
+}
+
+unsigned long long LatencyHistogram::percentile(double q) const {
+  long long seen = 0;
+  for (int b = 0; b < BUCKETS; b++) {
+    seen += counts[b];
+    if (seen > 0 && seen >= q * samples)
+      return bucket_max(b);
+  }
+  return 0;
+}
+
+void LatencyHistogram::print() const {
+  std::cout << "AMAT:               " << std::fixed << std::setprecision(2)
+            << average() << " cycles (" << samples << " accesses, " << total
+            << " cycles)\n";
+  if (samples == 0)
+    return;
+  std::cout << "Percentiles:        p50 <= " << percentile(0.5)
+            << ", p90 <= " << percentile(0.9) << ", p99 <= "
+            << percentile(0.99) << " cycles\n";
+  std::cout << "Latency Histogram (cycles):\n";
+  for (int b = 0; b < BUCKETS; b++) {
+    if (counts[b] == 0)
+      continue;
+    double share = (double)counts[b] / samples * 100.0;
+    std::string range = std::to_string(b == 0 ? 0 : 1ULL << (b - 1));
+    if (b > 1)
+      range += "-" + std::to_string(bucket_max(b));
+    std::cout << "  " << std::left << std::setw(18) << range << std::right
+              << std::setw(12) << counts[b] << std::setw(8)
+              << std::setprecision(2) << share << "%  "
+              << std::string((size_t)(share / 2.5 + 0.5), '#') << "\n";
+  }
+}
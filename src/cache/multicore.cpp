@@ -0,0 +1,303 @@
+#include "../../include/MultiCore.h"
+#include "../../include/Allocator.h"
+#include <algorithm>
+#include <iomanip>
+
+MultiCoreSystem::MultiCoreSystem(const std::vector<CacheLevel *> &l1s,
+                                 const std::vector<CacheLevel *> &l2s,
+                                 CacheLevel *shared, CoherenceProtocol proto,
+                                 Allocator *sm)
+    : llc(shared), protocol(proto), std_mem(sm),
+      block_size(shared->get_block_size()) {
+  for (size_t i = 0; i < l1s.size(); i++)
+    cores.push_back({l1s[i], l2s[i]});
+}
+
+MultiCoreSystem::~MultiCoreSystem() {
+  for (Core &core : cores) {
+    delete core.l1;
+    delete core.l2;
+  }
+  delete llc;
+}
+
+MultiCoreSystem::LineStats &MultiCoreSystem::line(unsigned long long block) {
+  LineStats &stats = lines[block];
+  if (stats.read_chunks.empty()) {
+    stats.read_chunks.assign(cores.size(), 0);
+    stats.write_chunks.assign(cores.size(), 0);
+  }
+  return stats;
+}
+
+void MultiCoreSystem::access(int core, unsigned long long address,
+                             bool is_write) {
+  if (core < 0 || core >= (int)cores.size()) {
+    bad_core++;
+    return;
+  }
+  Core &c = cores[core];
+  unsigned long long block = address & ~(unsigned long long)(block_size - 1);
+
+  bool l1_hit = c.l1->lookup(address);
+  bool present = l1_hit || c.l2->lookup(address);
+  if (!present) {
+    if (std_mem && !std_mem->is_allocated(address)) {
+      invalid_accesses++; // Not cached, as in CacheController
+      return;
+    }
+    miss(core, block, is_write);
+    CacheEviction victim = c.l2->allocate(address);
+    if (victim.valid)
+      evict_private(core, victim.address);
+    c.l1->allocate(address);
+  } else {
+    if (!l1_hit)
+      c.l1->allocate(address); // The L2 still holds any L1 victim
+    if (is_write)
+      write_hit(core, block);
+  }
+
+  // Which bytes each core touches in lines with coherence events
+  if (!lines.empty()) {
+    auto it = lines.find(block);
+    if (it != lines.end()) {
+      unsigned chunk = (unsigned)((address - block) * 64 / block_size);
+      std::vector<uint64_t> &chunks =
+          is_write ? it->second.write_chunks : it->second.read_chunks;
+      chunks[core] |= 1ULL << chunk;
+    }
+  }
+}
+
+void MultiCoreSystem::miss(int core, unsigned long long block, bool is_write) {
+  DirEntry &entry = directory[block];
+  uint64_t me = 1ULL << core;
+  if (is_write)
+    bus_read_exclusive++;
+  else
+    bus_reads++;
+
+  if (entry.sharers & ~me) {
+    // Another core supplies the line
+    transfers++;
+    LineStats &stats = line(block);
+    stats.transfers++;
+    if (is_write) {
+      stats.invalidations += invalidate_others(core, block, entry);
+    } else if (entry.owner >= 0) {
+      if (entry.owner_state == OWNER_M) {
+        if (protocol == COHERENCE_MOESI) {
+          entry.owner_state = OWNER_O; // Keeps the dirty line, shared
+        } else {
+          write_back(block);
+          entry.owner = -1; // M -> S
+        }
+      } else if (entry.owner_state == OWNER_E) {
+        entry.owner = -1; // E -> S
+      }
+    }
+  } else if (!llc->lookup(block)) {
+    // No copy on chip: memory fills the LLC too
+    memory_reads++;
+    llc->allocate(block);
+  }
+
+  entry.sharers |= me;
+  if (is_write) {
+    entry.owner = core;
+    entry.owner_state = OWNER_M;
+  } else if (entry.sharers == me) {
+    entry.owner = core;
+    entry.owner_state = OWNER_E;
+  }
+}
+
+void MultiCoreSystem::write_hit(int core, unsigned long long block) {
+  DirEntry &entry = directory[block];
+  if (entry.owner == core && entry.owner_state == OWNER_M)
+    return;
+  if (entry.owner == core && entry.owner_state == OWNER_E) {
+    entry.owner_state = OWNER_M; // Silent upgrade
+    return;
+  }
+
+  // S or O: BusUpgr
+  upgrades++;
+  LineStats &stats = line(block);
+  stats.upgrades++;
+  stats.invalidations += invalidate_others(core, block, entry);
+  entry.owner = core;
+  entry.owner_state = OWNER_M;
+}
+
+int MultiCoreSystem::invalidate_others(int core, unsigned long long block,
+                                       DirEntry &entry) {
+  uint64_t others = entry.sharers & ~(1ULL << core);
+  int removed = 0;
+  for (int p = 0; others; p++, others >>= 1) {
+    if (!(others & 1))
+      continue;
+    // Dirty data moves to the requester, so nothing is written back
+    cores[p].l1->invalidate(block);
+    cores[p].l2->invalidate(block);
+    removed++;
+  }
+  entry.sharers &= 1ULL << core;
+  if (entry.owner != core)
+    entry.owner = -1;
+  invalidations += removed;
+  return removed;
+}
+
+void MultiCoreSystem::evict_private(int core, unsigned long long block) {
+  cores[core].l1->invalidate(block); // Private L2 is inclusive
+  auto it = directory.find(block);
+  if (it == directory.end())
+    return;
+  DirEntry &entry = it->second;
+  if (entry.owner == core) {
+    if (entry.owner_state != OWNER_E)
+      write_back(block); // M or O
+    entry.owner = -1;
+  }
+  entry.sharers &= ~(1ULL << core);
+  if (!entry.sharers)
+    directory.erase(it);
+}
+
+void MultiCoreSystem::write_back(unsigned long long block) {
+  writebacks++;
+  if (!llc->contains(block))
+    llc->allocate(block); // A dirty LLC victim is counted by the LLC
+  llc->absorb_write(block);
+}
+
+// Sharing pattern of a tracked line: "false" if every writer's bytes are
+// untouched by the other cores
+static const char *classify(const std::vector<uint64_t> &reads,
+                            const std::vector<uint64_t> &writes, int &cores,
+                            int &writers) {
+  cores = writers = 0;
+  for (size_t i = 0; i < reads.size(); i++) {
+    cores += (reads[i] | writes[i]) != 0;
+    writers += writes[i] != 0;
+  }
+  if (writers == 0)
+    return "read-only";
+  if (cores < 2)
+    return "private";
+  for (size_t i = 0; i < writes.size(); i++) {
+    for (size_t j = 0; j < reads.size(); j++) {
+      if (i != j && (writes[i] & (reads[j] | writes[j])))
+        return "true";
+    }
+  }
+  return "false";
+}
+
+void MultiCoreSystem::print_stats(int top) {
+  std::cout << "--- Multi-Core Statistics ("
+            << (protocol == COHERENCE_MOESI ? "MOESI" : "MESI") << ", "
+            << cores.size() << " cores) ---\n";
+  for (Core &core : cores) {
+    core.l1->print_stats();
+    core.l2->print_stats();
+  }
+  llc->print_stats();
+  std::cout << "Bus Reads: " << bus_reads
+            << ", Read-Exclusive: " << bus_read_exclusive
+            << ", Upgrades: " << upgrades << "\n";
+  std::cout << "Invalidations: " << invalidations
+            << ", Cache-to-Cache Transfers: " << transfers
+            << ", Writebacks: " << writebacks
+            << ", Memory Reads: " << memory_reads << "\n";
+  if (invalid_accesses > 0)
+    std::cout << "Invalid Accesses: " << invalid_accesses << "\n";
+  if (bad_core > 0)
+    std::cout << "Records for Missing Cores: " << bad_core << "\n";
+
+  if (!lines.empty() && top > 0) {
+    typedef std::pair<unsigned long long, const LineStats *> Ranked;
+    std::vector<Ranked> ranked;
+    ranked.reserve(lines.size());
+    for (const auto &entry : lines)
+      ranked.push_back({entry.first, &entry.second});
+    size_t shown = std::min(ranked.size(), (size_t)top);
+    std::partial_sort(ranked.begin(), ranked.begin() + shown, ranked.end(),
+                      [](const Ranked &a, const Ranked &b) {
+                        long long ea = a.second->invalidations +
+                                       a.second->transfers;
+                        long long eb = b.second->invalidations +
+                                       b.second->transfers;
+                        return ea != eb ? ea > eb : a.first < b.first;
+                      });
+
+    std::cout << "Coherence Hotspots (top " << shown << " of " << lines.size()
+              << " lines):\n";
+    std::cout << "  Line Address        Inval    Upgr     C2C  Cores  "
+                 "Writers  Sharing\n";
+    for (size_t i = 0; i < shown; i++) {
+      const LineStats &stats = *ranked[i].second;
+      int sharing_cores, writers;
+      const char *sharing = classify(stats.read_chunks, stats.write_chunks,
+                                     sharing_cores, writers);
+      std::cout << "  0x" << std::hex << std::left << std::setw(16)
+                << ranked[i].first << std::dec << std::right << std::setw(7)
+                << stats.invalidations << std::setw(8) << stats.upgrades
+                << std::setw(8) << stats.transfers << std::setw(7)
+                << sharing_cores << std::setw(9) << writers << "  " << sharing
+                << "\n";
+    }
+  }
+  std::cout << "----------------------\n";
+}
+
+// --- Factory ---
+
+static bool valid_level(const char *name, size_t size, size_t block_size,
+                        int assoc) {
+  size_t sets = (assoc > 0 && block_size > 0) ? size / (block_size * assoc) : 0;
+  if (sets == 0 || sets * block_size * assoc != size ||
+      (sets & (sets - 1)) != 0) {
+    std::cout << "Error: " << name << " needs size = sets x block x ways with "
+              << "a power-of-two set count.\n";
+    return false;
+  }
+  return true;
+}
+
+MultiCoreSystem *create_multicore(int num_cores, size_t l1_size,
+                                  size_t block_size, int assoc,
+                                  size_t llc_size, CoherenceProtocol proto,
+                                  Allocator *sm) {
+  if (num_cores < 1 || num_cores > 64) {
+    std::cout << "Error: 1-64 cores are supported.\n";
+    return nullptr;
+  }
+  if (block_size == 0 || (block_size & (block_size - 1)) != 0) {
+    std::cout << "Error: Block size must be a power of two.\n";
+    return nullptr;
+  }
+  int llc_ways = 16;
+  if (!valid_level("L1", l1_size, block_size, assoc) ||
+      !valid_level("L2", l1_size * 8, block_size, assoc))
+    return nullptr;
+  if (llc_size % (block_size * llc_ways) != 0 ||
+      ((llc_size / (block_size * llc_ways)) &
+       (llc_size / (block_size * llc_ways) - 1)) != 0)
+    llc_ways = assoc;
+  if (!valid_level("LLC", llc_size, block_size, llc_ways))
+    return nullptr;
+
+  std::vector<CacheLevel *> l1s, l2s;
+  for (int i = 0; i < num_cores; i++) {
+    l1s.push_back(create_cache_level(1, l1_size, block_size, assoc));
+    l2s.push_back(create_cache_level(2, l1_size * 8, block_size, assoc));
+    l1s.back()->set_name("C" + std::to_string(i) + " L1");
+    l2s.back()->set_name("C" + std::to_string(i) + " L2");
+  }
+  CacheLevel *llc = create_cache_level(3, llc_size, block_size, llc_ways);
+  llc->set_name("LLC");
+  return new MultiCoreSystem(l1s, l2s, llc, proto, sm);
+}
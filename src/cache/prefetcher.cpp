@@ -0,0 +1,137 @@
+#include "../../include/Prefetcher.h"
+#include <algorithm>
+#include <iostream>
+
+// --- Next-Line ---
+
+void NextLinePrefetcher::observe(unsigned long long address,
+                                 unsigned long long pc, bool miss,
+                                 bool prefetch_hit,
+                                 std::vector<unsigned long long> &out) {
+  if (!miss && !prefetch_hit)
+    return;
+  unsigned long long block = address / block_size;
+  for (int k = 1; k <= degree; k++)
+    out.push_back((block + k) * block_size);
+}
+
+// --- IP-Stride ---
+
+void IPStridePrefetcher::observe(unsigned long long address,
+                                 unsigned long long pc, bool miss,
+                                 bool prefetch_hit,
+                                 std::vector<unsigned long long> &out) {
+  if (pc == 0)
+    return;
+  Entry &e = table[(pc ^ (pc >> 8)) % TABLE_SIZE];
+  long long block = (long long)(address / block_size);
+  if (e.pc != pc) {
+    e = Entry();
+    e.pc = pc;
+    e.last_block = block;
+    return;
+  }
+
+  long long stride = block - e.last_block;
+  if (stride == 0)
+    return; // Same block: nothing learned
+  if (stride == e.stride) {
+    if (e.confidence < 3)
+      e.confidence++;
+  } else {
+    if (e.confidence > 0)
+      e.confidence--;
+    if (e.confidence == 0)
+      e.stride = stride;
+  }
+  e.last_block = block;
+
+  if (e.confidence < 2)
+    return;
+  for (int k = 1; k <= degree; k++) {
+    long long target = block + e.stride * k;
+    if (target >= 0)
+      out.push_back((unsigned long long)target * block_size);
+  }
+}
+
+// --- Stream ---
+
+void StreamPrefetcher::observe(unsigned long long address,
+                               unsigned long long pc, bool miss,
+                               bool prefetch_hit,
+                               std::vector<unsigned long long> &out) {
+  if (!miss && !prefetch_hit)
+    return;
+  long long block = (long long)(address / block_size);
+  unsigned long long region = address >> 12;
+  tick++;
+
+  Stream *s = nullptr;
+  Stream *oldest = &streams[0];
+  for (Stream &candidate : streams) {
+    if (candidate.valid && candidate.region == region) {
+      s = &candidate;
+      break;
+    }
+    if (!candidate.valid || (oldest->valid && candidate.lru < oldest->lru))
+      oldest = &candidate;
+  }
+  if (!s) {
+    // New stream, untrained
+    *oldest = Stream();
+    oldest->valid = true;
+    oldest->region = region;
+    oldest->last_block = oldest->front = block;
+    oldest->lru = tick;
+    return;
+  }
+  s->lru = tick;
+
+  long long delta = block - s->last_block;
+  if (delta == 0)
+    return;
+  int direction = delta > 0 ? 1 : -1;
+  if (direction == s->direction) {
+    if (s->confidence < 3)
+      s->confidence++;
+  } else {
+    s->direction = direction;
+    s->confidence = 1;
+    s->front = block;
+  }
+  s->last_block = block;
+  if (s->confidence < 2)
+    return;
+
+  // Run ahead to block + direction * degree, skipping what is already out
+  long long target = block + direction * degree;
+  long long next = direction > 0 ? std::max(s->front, block) + 1
+                                 : std::min(s->front, block) - 1;
+  for (long long b = next; direction > 0 ? b <= target : b >= target;
+       b += direction) {
+    if (b < 0)
+      break;
+    out.push_back((unsigned long long)b * block_size);
+  }
+  s->front = target;
+}
+
+// --- Factory ---
+
+Prefetcher *create_prefetcher(const std::string &name, size_t block_size,
+                              int degree) {
+  if (degree < 1) {
+    std::cout << "Error: Prefetch degree must be at least 1.\n";
+    return nullptr;
+  }
+  if (name == "next-line")
+    return new NextLinePrefetcher(block_size, degree);
+  if (name == "ip-stride")
+    return new IPStridePrefetcher(block_size, degree);
+  if (name == "stream")
+    return new StreamPrefetcher(block_size, degree);
+  std::cout << "Error: Unknown prefetcher '" << name
+            << "' (use next-line, ip-stride or stream).\n";
+  return nullptr;
+}
@@ -0,0 +1,114 @@
+#include "../../include/ReplacementPolicy.h"
+#include <iostream>
+
+// --- LRU ---
+
+LRUPolicy::LRUPolicy(int sets, int assoc)
+    : ReplacementPolicy(sets, assoc), last_used((size_t)sets * assoc, 0) {}
+
+// --- FIFO ---
+
+FIFOPolicy::FIFOPolicy(int sets, int assoc)
+    : ReplacementPolicy(sets, assoc), filled_at((size_t)sets * assoc, 0) {}
+
+// --- Random ---
+
+RandomPolicy::RandomPolicy(int sets, int assoc)
+    : ReplacementPolicy(sets, assoc), state(sets) {
+  for (int s = 0; s < sets; s++) {
+    state[s] = (uint32_t)s * 2654435761u + 1; // Never zero for xorshift
+    if (state[s] == 0)
+      state[s] = 1;
+  }
+}
+
+// --- Tree-PLRU ---
+
+TreePLRUPolicy::TreePLRUPolicy(int sets, int assoc)
+    : ReplacementPolicy(sets, assoc), tree(sets, 0) {
+  levels = 0;
+  while ((1 << levels) < assoc)
+    levels++;
+}
+
+// --- Bit-PLRU ---
+
+BitPLRUPolicy::BitPLRUPolicy(int sets, int assoc)
+    : ReplacementPolicy(sets, assoc), mru(sets, 0) {
+  full_mask = (assoc == 64) ? ~0ULL : ((1ULL << assoc) - 1);
+}
+
+// --- SRRIP / BRRIP ---
+
+static const uint8_t RRPV_MAX = 3;
+
+RRIPPolicy::RRIPPolicy(int sets, int assoc, bool brrip)
+    : ReplacementPolicy(sets, assoc), rrpv((size_t)sets * assoc, RRPV_MAX),
+      fills(brrip ? sets : 0, 0), bimodal(brrip) {}
+
+void RRIPPolicy::on_fill(size_t set, int way) {
+  uint8_t insert = RRPV_MAX - 1;
+  if (bimodal) {
+    // Mostly distant, occasionally long, so part of a scan can stick
+    uint8_t n = fills[set]++;
+    if (n % 32 != 0)
+      insert = RRPV_MAX;
+  }
+  rrpv[set * ways + way] = insert;
+}
+
+int RRIPPolicy::victim(size_t set) {
+  uint8_t *r = &rrpv[set * ways];
+  // Aging every way until one reaches RRPV_MAX is the same as adding the
+  // gap between the oldest and RRPV_MAX in one step.
+  uint8_t oldest = 0;
+  int way = 0;
+  for (int i = 0; i < ways; i++) {
+    if (r[i] > oldest) {
+      oldest = r[i];
+      way = i;
+    }
+  }
+  if (oldest < RRPV_MAX) {
+    uint8_t gap = RRPV_MAX - oldest;
+    for (int i = 0; i < ways; i++)
+      r[i] += gap;
+  }
+  return way;
+}
+
+// --- Factory ---
+
+ReplacementPolicy *create_replacement_policy(const std::string &name, int sets,
+                                             int ways) {
+  bool pow2 = ways > 0 && (ways & (ways - 1)) == 0;
+  if (name == "lru")
+    return new LRUPolicy(sets, ways);
+  if (name == "fifo")
+    return new FIFOPolicy(sets, ways);
+  if (name == "random")
+    return new RandomPolicy(sets, ways);
+  if (name == "srrip")
+    return new RRIPPolicy(sets, ways, false);
+  if (name == "brrip")
+    return new RRIPPolicy(sets, ways, true);
+  if (name == "tree-plru" || name == "plru") {
+    if (!pow2 || ways > 64) {
+      std::cout << "Error: tree-plru needs a power-of-two associativity up to "
+                   "64.\n";
+      return nullptr;
+    }
+    return new TreePLRUPolicy(sets, ways);
+  }
+  if (name == "bit-plru") {
+    if (ways > 64) {
+      std::cout << "Error: bit-plru supports at most 64 ways.\n";
+      return nullptr;
+    }
+    return new BitPLRUPolicy(sets, ways);
+  }
+  std::cout << "Error: Unknown replacement policy '" << name
+            << "'. Use lru, fifo, random, tree-plru, bit-plru, srrip or "
+               "brrip.\n";
+  return nullptr;
+}
@@ -0,0 +1,145 @@
+#include "../../include/StackDistance.h"
+#include "../../include/Trace.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static unsigned long long floor_pow2(unsigned long long n) {
+  unsigned long long p = 1;
+  while (p * 2 <= n)
+    p *= 2;
+  return p;
+}
+
+StackDistanceAnalyzer::StackDistanceAnalyzer(int bs, unsigned long long size,
+                                             int ways)
+    : block_size(bs), offset_bits(0) {
+  while ((1 << offset_bits) < block_size)
+    offset_bits++;
+  max_size = floor_pow2(size < (unsigned long long)bs ? bs : size);
+  max_ways = (int)floor_pow2(ways < 1 ? 1 : ways);
+
+  unsigned long long max_blocks = max_size / block_size;
+  fa_hist.assign(max_blocks, 0);
+
+  // Set counts from fully associative (1 set) up to direct mapped at the
+  // largest capacity; each only as deep as its widest covered cache
+  for (unsigned long long sets = 1; sets <= max_blocks; sets *= 2) {
+    SetStacks s;
+    s.sets = (int)sets;
+    s.depth = (int)std::min<unsigned long long>(max_ways, max_blocks / sets);
+    s.stack.assign(sets * s.depth, 0);
+    s.hist.assign(s.depth + 1, 0);
+    set_counts.push_back(std::move(s));
+  }
+}
+
+void StackDistanceAnalyzer::access(unsigned long long address) {
+  unsigned long long block = address >> offset_bits;
+  unsigned long long now = accesses++;
+
+  // 1. Fully associative: distance = blocks used since this one's last use
+  auto it = last_use.find(block);
+  if (it == last_use.end()) {
+    fa_beyond++; // Cold miss
+    last_use.emplace(block, now);
+  } else {
+    unsigned long long prev = it->second;
+    size_t distance = recent.size() - recent.order_of_key(prev) - 1;
+    if (distance < fa_hist.size())
+      fa_hist[distance]++;
+    else
+      fa_beyond++;
+    recent.erase(prev);
+    it->second = now;
+  }
+  recent.insert(now);
+
+  // 2. Set associative: move-to-front in this block's set for every set
+  // count
+  unsigned long long key = block + 1;
+  for (SetStacks &s : set_counts) {
+    unsigned long long *stack =
+        &s.stack[(block & (unsigned long long)(s.sets - 1)) * s.depth];
+    int d = 0;
+    while (d < s.depth && stack[d] != key)
+      d++;
+    s.hist[d]++; // d == depth: deeper than tracked (or cold)
+    int top = (d == s.depth) ? s.depth - 1 : d;
+    for (int i = top; i > 0; i--)
+      stack[i] = stack[i - 1];
+    stack[0] = key;
+  }
+}
+
+long long StackDistanceAnalyzer::misses(unsigned long long capacity,
+                                        int ways) const {
+  if (capacity < (unsigned long long)block_size || capacity > max_size)
+    return -1;
+  unsigned long long blocks = capacity / block_size;
+
+  if (ways == 0) {
+    long long total = fa_beyond;
+    for (size_t d = blocks; d < fa_hist.size(); d++)
+      total += fa_hist[d];
+    return total;
+  }
+
+  if (blocks % ways != 0)
+    return -1;
+  unsigned long long sets = blocks / ways;
+  for (const SetStacks &s : set_counts) {
+    if ((unsigned long long)s.sets != sets)
+      continue;
+    if (ways > s.depth)
+      return -1;
+    long long total = 0;
+    for (int d = ways; d <= s.depth; d++)
+      total += s.hist[d];
+    return total;
+  }
+  return -1;
+}
+
+void StackDistanceAnalyzer::print_curves() const {
+  std::cout << "--- LRU Miss Ratio Curves (" << block_size << "B blocks, "
+            << accesses << " accesses) ---\n";
+  std::cout << std::setw(12) << "Capacity" << std::setw(9) << "Full";
+  for (int w = 1; w <= max_ways; w *= 2)
+    std::cout << std::setw(8) << (std::to_string(w) + "-way");
+  std::cout << "\n";
+
+  unsigned long long first = block_size < 1024 ? 1024 : block_size;
+  for (unsigned long long cap = first; cap <= max_size; cap *= 2) {
+    std::cout << std::setw(12) << cap;
+    for (int w = 0; w <= max_ways; w = w ? w * 2 : 1) {
+      long long m = misses(cap, w);
+      std::ostringstream cell;
+      if (m < 0 || accesses == 0)
+        cell << "-";
+      else
+        cell << std::fixed << std::setprecision(2)
+             << (double)m / accesses * 100.0 << "%";
+      std::cout << std::setw(w ? 8 : 9) << cell.str();
+    }
+    std::cout << "\n";
+  }
+  std::cout << "(Miss ratios; '-' = not covered. Cold misses included.)\n";
+}
+
+bool run_stack_distance(const std::string &trace_path, int block_size,
+                        unsigned long long max_size, int max_ways) {
+  TraceFile trace;
+  if (!trace.open(trace_path))
+    return false;
+
+  StackDistanceAnalyzer analyzer(block_size, max_size, max_ways);
+  for (const TraceRecord &record : trace) {
+    if (record.op == TRACE_READ || record.op == TRACE_WRITE ||
+        record.op == TRACE_IFETCH)
+      analyzer.access(record.address);
+  }
+  analyzer.print_curves();
+  return true;
+}
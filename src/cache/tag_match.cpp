@@ -0,0 +1,231 @@
+#include "../../include/TagMatch.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TAG_MATCH_X86 1
+#include <immintrin.h>
+#endif
+
+// --- Scalar Kernels (portable reference) ---
+
+static int find_way_scalar(const unsigned long long *tags, const uint8_t *valid,
+                           int ways, unsigned long long tag) {
+  for (int i = 0; i < ways; i++) {
+    if (tags[i] == tag && valid[i])
+      return i;
+  }
+  return -1;
+}
+
+static int find_invalid_scalar(const uint8_t *valid, int ways) {
+  for (int i = 0; i < ways; i++) {
+    if (!valid[i])
+      return i;
+  }
+  return -1;
+}
+
+static int find_oldest_scalar(const unsigned long long *stamps, int ways) {
+  int oldest = 0;
+  for (int i = 1; i < ways; i++) {
+    if (stamps[i] < stamps[oldest])
+      oldest = i;
+  }
+  return oldest;
+}
+
+static const TagKernels scalar_kernels = {"scalar", find_way_scalar,
+                                          find_invalid_scalar,
+                                          find_oldest_scalar};
+
+#ifdef TAG_MATCH_X86
+
+// Checks candidate ways (bits of mask, lowest first) against the valid bytes
+static inline int first_valid(unsigned mask, int base, const uint8_t *valid) {
+  while (mask) {
+    int way = base + __builtin_ctz(mask);
+    if (valid[way])
+      return way;
+    mask &= mask - 1;
+  }
+  return -1;
+}
+
+// Lowest way holding the reduced minimum, so ties resolve like the scalar loop
+static inline int first_equal(const unsigned long long *stamps, int ways,
+                              unsigned long long value) {
+  for (int i = 0; i < ways; i++) {
+    if (stamps[i] == value)
+      return i;
+  }
+  return 0;
+}
+
+// --- AVX2 Kernels (4 tags per compare) ---
+
+__attribute__((target("avx2"))) static int
+find_way_avx2(const unsigned long long *tags, const uint8_t *valid, int ways,
+              unsigned long long tag) {
+  const __m256i key = _mm256_set1_epi64x((long long)tag);
+  int i = 0;
+  for (; i + 8 <= ways; i += 8) {
+    __m256i lo = _mm256_loadu_si256((const __m256i *)(tags + i));
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(tags + i + 4));
+    unsigned mask =
+        (unsigned)_mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpeq_epi64(lo, key))) |
+        ((unsigned)_mm256_movemask_pd(
+             _mm256_castsi256_pd(_mm256_cmpeq_epi64(hi, key)))
+         << 4);
+    int way = first_valid(mask, i, valid);
+    if (way != -1)
+      return way;
+  }
+  for (; i < ways; i++) {
+    if (tags[i] == tag && valid[i])
+      return i;
+  }
+  return -1;
+}
+
+__attribute__((target("avx2"))) static int find_invalid_avx2(const uint8_t *valid,
+                                                           int ways) {
+  const __m256i zero = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 32 <= ways; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(valid + i));
+    unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  for (; i + 16 <= ways; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(valid + i));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  for (; i < ways; i++) {
+    if (!valid[i])
+      return i;
+  }
+  return -1;
+}
+
+// Unsigned 64-bit min: AVX2 only has a signed compare, so both sides are
+// biased by the sign bit first. The minimum is then broadcast back and
+// matched against the set to find its lowest way.
+__attribute__((target("avx2"))) static int
+find_oldest_avx2(const unsigned long long *stamps, int ways) {
+  const __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+  int vec_ways = ways & ~3;
+  __m256i best =
+      _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)stamps), bias);
+  for (int i = 4; i < vec_ways; i += 4) {
+    __m256i v = _mm256_xor_si256(
+        _mm256_loadu_si256((const __m256i *)(stamps + i)), bias);
+    best = _mm256_blendv_epi8(best, v, _mm256_cmpgt_epi64(best, v));
+  }
+
+  // Horizontal min: swap 128-bit halves, then 64-bit lanes
+  __m256i swapped = _mm256_permute4x64_epi64(best, 0x4E);
+  best = _mm256_blendv_epi8(best, swapped, _mm256_cmpgt_epi64(best, swapped));
+  swapped = _mm256_permute4x64_epi64(best, 0xB1);
+  best = _mm256_blendv_epi8(best, swapped, _mm256_cmpgt_epi64(best, swapped));
+  unsigned long long oldest =
+      (unsigned long long)_mm256_extract_epi64(best, 0) ^ 0x8000000000000000ULL;
+  for (int i = vec_ways; i < ways; i++) {
+    if (stamps[i] < oldest)
+      oldest = stamps[i];
+  }
+
+  const __m256i key = _mm256_set1_epi64x((long long)oldest);
+  for (int i = 0; i < vec_ways; i += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(stamps + i));
+    unsigned mask = (unsigned)_mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(v, key)));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return first_equal(stamps + vec_ways, ways - vec_ways, oldest) + vec_ways;
+}
+
+static const TagKernels avx2_kernels = {"avx2", find_way_avx2,
+                                        find_invalid_avx2, find_oldest_avx2};
+// Below 32 ways the min-reduction loses to the scalar loop; tag compare wins
+static const TagKernels avx2_narrow_kernels = {"avx2", find_way_avx2,
+                                               find_invalid_avx2,
+                                               find_oldest_scalar};
+
+// --- SSE4.2 Kernels (2 tags per compare) ---
+
+__attribute__((target("sse4.2"))) static int
+find_way_sse42(const unsigned long long *tags, const uint8_t *valid, int ways,
+               unsigned long long tag) {
+  const __m128i key = _mm_set1_epi64x((long long)tag);
+  int i = 0;
+  for (; i + 4 <= ways; i += 4) {
+    __m128i lo = _mm_loadu_si128((const __m128i *)(tags + i));
+    __m128i hi = _mm_loadu_si128((const __m128i *)(tags + i + 2));
+    unsigned mask =
+        (unsigned)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(lo, key))) |
+        ((unsigned)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(hi, key)))
+         << 2);
+    int way = first_valid(mask, i, valid);
+    if (way != -1)
+      return way;
+  }
+  for (; i < ways; i++) {
+    if (tags[i] == tag && valid[i])
+      return i;
+  }
+  return -1;
+}
+
+__attribute__((target("sse4.2"))) static int
+find_invalid_sse42(const uint8_t *valid, int ways) {
+  int i = 0;
+  for (; i + 16 <= ways; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(valid + i));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  for (; i < ways; i++) {
+    if (!valid[i])
+      return i;
+  }
+  return -1;
+}
+
+// Two-lane min-reduction does not beat the scalar loop, so LRU search stays
+// scalar on SSE-only hosts.
+static const TagKernels sse42_kernels = {"sse4.2", find_way_sse42,
+                                         find_invalid_sse42, find_oldest_scalar};
+
+#endif // TAG_MATCH_X86
+
+// --- Dispatch ---
+
+const TagKernels &select_tag_kernels(int ways, bool allow_simd) {
+  // Below 16 ways the scalar loops exit early enough to win
+  if (!allow_simd || ways < 16)
+    return scalar_kernels;
+#ifdef TAG_MATCH_X86
+  static const int level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return 2;
+    if (__builtin_cpu_supports("sse4.2"))
+      return 1;
+    return 0;
+  }();
+  if (level == 2)
+    return (ways >= 32) ? avx2_kernels : avx2_narrow_kernels;
+  if (level == 1)
+    return sse42_kernels;
+  return scalar_kernels;
+#else
+  return scalar_kernels;
+#endif
+}
@@ -1,9 +1,24 @@
-#include "../include/Cache.h"         // Cache System
-#include "../include/MemoryManager.h" // Standard Allocator
-#include "../include/VirtualMemory.h" // Virtual Memory System
+#include "../include/BuddyAllocator.h" // Buddy Allocator
+#include "../include/Cache.h"          // Cache System
+#include "../include/MemoryManager.h"  // Standard Allocator
+#include "../include/SlabAllocator.h"  // Slab Allocator
+#include "../include/VirtualMemory.h"  // Virtual Memory System
+#include "../include/Trace.h"          // Binary Trace Files
+#include "../include/StackDistance.h"  // Miss Ratio Curves
+#include "../include/ShardedCache.h"   // Set-Parallel Replay
+#include "../include/Prefetcher.h"     // Hardware Prefetchers
+#include "../include/MultiCore.h"      // Multi-Core Coherence
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits> // For numeric_limits
+#include <sstream>
 #include <string>
+#include <thread>
 
 
 // --- Helper Functions for Help Menus ---
@@ -11,11 +26,15 @@
 void print_generic_help() {
   std::cout << "--- General Help ---\n";
   std::cout << "Available Commands:\n";
-  std::cout << "  init standard <size>     : Initialize memory allocator\n";
+  std::cout << "  init <standard|buddy|slab> <size> : Initialize memory "
+               "allocator\n";
   std::cout << "  init_cache <size> <block> <ways> : Initialize L1/L2 Cache\n";
-  std::cout << "  init_mmu <page_size>             : Initialize Virtual Memory "
+  std::cout << "  init_hierarchy <config>          : Initialize caches from "
+               "a config file\n";
+  std::cout << "  init_mmu <page_size> [policy]    : Initialize Virtual Memory "
                "(MMU)\n";
-  std::cout << "  help <standard|cache|mmu>  : Specific help menus\n";
+  std::cout << "  help <standard|buddy|slab|cache|mmu> : Specific help "
+               "menus\n";
   std::cout << "  exit                             : Quit\n";
 }
 
@@ -32,263 +51,1247 @@ void print_standard_help() {
       << "  stats                            : Show fragmentation stats\n";
 }
 
+void print_buddy_help() {
+  std::cout << "--- Buddy Allocator Help ---\n";
+  std::cout << "Usage: init buddy <size>\n";
+  std::cout << "  Blocks are powers of two (min 16 bytes); requests are "
+               "rounded up.\n";
+  std::cout << "Commands:\n";
+  std::cout << "  malloc <size>                    : Allocate memory\n";
+  std::cout << "  free <address>                   : Free block by address\n";
+  std::cout << "  dump                             : Show block map\n";
+  std::cout
+      << "  stats                            : Show internal/external "
+         "fragmentation\n";
+}
+
+void print_slab_help() {
+  std::cout << "--- Slab Allocator Help ---\n";
+  std::cout << "Usage: init slab <size> [slab_size]\n";
+  std::cout << "  Small requests are rounded to jemalloc-style size classes "
+               "and served\n";
+  std::cout << "  from per-class slabs (default 4096 bytes). Larger requests "
+               "bypass slabs.\n";
+  std::cout << "Commands:\n";
+  std::cout << "  malloc <size>                    : Allocate memory\n";
+  std::cout << "  free <address>                   : Free region by address\n";
+  std::cout << "  dump                             : Show per-class bins\n";
+  std::cout
+      << "  stats                            : Show internal fragmentation\n";
+}
+
 void print_cache_help() {
   std::cout << "--- Cache Simulation Help ---\n";
-  std::cout << "Usage: init_cache <TotalSize> <BlockSize> <Associativity>\n";
+  std::cout << "Usage: init_cache <TotalSize> <BlockSize> <Associativity> "
+               "[L1Policy] [L2Policy]\n";
   std::cout
       << "  <TotalSize>    : Total bytes in L1 (L2 is auto-set to 8x this)\n";
   std::cout << "  <BlockSize>    : Bytes per cache line (e.g., 64)\n";
   std::cout
       << "  <Associativity>: 1 = Direct Mapped, 2 = 2-Way Set Assoc, etc.\n";
+  std::cout << "  [Policy]       : lru (default), fifo, random, tree-plru, "
+               "bit-plru,\n"
+               "                   srrip, brrip (L2 defaults to the L1 "
+               "policy)\n";
   std::cout << "\nCommands:\n";
-  std::cout << "  access <addr> <r|w> : Simulate access (Virtual if MMU "
-               "active, else Physical)\n";
+  std::cout << "  access <addr> <r|w|x> [pc] : Simulate access (Virtual if "
+               "MMU active, else\n"
+               "                        Physical); pc feeds ip-stride "
+               "prefetchers\n";
+  std::cout << "  replay <trace.bin>  : Replay a binary trace through the "
+               "active system\n";
+  std::cout << "  convert <text|lackey|perf> <input> <output>\n"
+               "                      : Write a binary trace (as --convert)\n";
   std::cout << "  cache_stats         : Show Hits, Misses, and Hit Rate\n";
+  std::cout << "  latency_stats       : AMAT, cycles per level and a latency "
+               "histogram\n";
+  std::cout << "  set latency <level|memory|dtlb|stlb|walk|fault> <cycles>\n"
+               "                      : Cycles per lookup (defaults: L1 4, "
+               "L2 10, L3 30,\n"
+               "                        memory 200, DTLB 1, STLB 7, walk 20 "
+               "per table\n"
+               "                        read, fault 300000)\n";
+  std::cout << "  mrc <trace.bin> <block> <max_size> [max_ways]\n"
+               "                      : LRU miss ratio of every size/ways in "
+               "one pass\n";
+  std::cout << "  shard_replay <trace.bin> <size> <block> <ways> [policy] "
+               "[threads]\n"
+               "                      : Replay one large cache split by set "
+               "across cores\n";
+  std::cout << "  sweep <sweep_file> [threads]\n"
+               "                      : Replay a trace through several "
+               "configurations (as --sweep)\n";
+  std::cout << "  set write_policy <level|all> <write-back|write-through>\n"
+               "      [write-allocate|no-write-allocate]\n"
+               "                      : Per-level write policy (default: "
+               "write-back,\n"
+               "                        write-allocate)\n";
+  std::cout << "  init_multicore <cores> <l1_size> <block> <ways> [mesi|moesi] "
+               "[llc_size]\n"
+               "                      : Private L1/L2 (8x) per core over a "
+               "shared LLC;\n"
+               "                        access <addr> <r|w> <pc> <core> "
+               "picks the core\n";
+  std::cout << "  coherence_stats [top] : Bus traffic and the lines with the "
+               "most coherence\n"
+               "                        events (false vs. true sharing)\n";
+  std::cout << "  prefetch <level> <none|next-line|ip-stride|stream> [degree] "
+               "[latency]\n"
+               "                      : Prefetcher for a data level (default "
+               "degree 2,\n"
+               "                        latency 16 accesses)\n";
 }
 
 void print_mmu_help() {
   std::cout << "--- Virtual Memory Help ---\n";
-  std::cout << "Usage: init_mmu <page_size>\n";
+  std::cout << "Usage: init_mmu <page_size> [policy]\n";
   std::cout << "  <page_size> : Size of a page/frame in bytes (e.g., 64)\n";
+  std::cout << "  [policy]    : Page replacement: lru (default), clock "
+               "(second-chance)\n"
+               "                or enhanced-clock (prefers clean pages)\n";
   std::cout << "\nCommands:\n";
   std::cout << "  access <v_addr> <r|w> : Access a Virtual Address (triggers "
                "translation)\n";
+  std::cout << "  init_tlb <dtlb_entries> <dtlb_ways> <stlb_entries> "
+               "<stlb_ways> [policy]\n"
+               "           [huge_entries huge_ways]\n"
+               "                        : Add a TLB in front of the page "
+               "table\n"
+               "                          (stlb_entries 0 = DTLB only; "
+               "e.g. 64 4 1536 12 lru 32 4\n"
+               "                          adds a separate 32-entry huge-page "
+               "DTLB)\n";
+  std::cout << "  set huge_pages <never|always|madvise>\n"
+               "                        : Map faults to huge pages (512 base "
+               "pages) when the\n"
+               "                          aligned range is empty "
+               "(madvise: huge_region only)\n";
+  std::cout << "  huge_region <v_addr> <length> : Allow huge pages in a "
+               "region (madvise mode)\n";
+  std::cout << "  set walk_cache <on|off> : Send page-walk reads (one per "
+               "table level)\n"
+               "                          through the cache\n";
+  std::cout << "  set page_replacement <policy> : Switch the page "
+               "replacement policy\n";
+  std::cout << "  switch <pid>          : Context switch; each PID has its own "
+               "page table\n"
+               "                          (trace records switch by their "
+               "PID)\n";
+  std::cout << "  set page_scope <global|local> : Evict from any process "
+               "(default) or\n"
+               "                          the faulting one\n";
+  std::cout << "  set asid <on|off>     : ASID-tagged TLB entries (off: flush "
+               "on every switch)\n";
   std::cout << "  pt_dump               : Dump the Page Table\n";
+  std::cout << "  mmu_stats             : Show Page Fault statistics\n";
 }
 
-// --- Main Function ---
+void print_usage() {
+  std::cout << "Usage: memsim [--trace <file>] [--quiet]\n";
+  std::cout << "       memsim --convert <text|lackey|perf> <input> <output>\n";
+  std::cout << "       memsim --sweep <sweep_file> [threads]\n";
+  std::cout << "  (no arguments)   : Interactive mode\n";
+  std::cout << "  --trace <file>   : Replay a command file non-interactively\n";
+  std::cout << "  --quiet          : Disable per-access output, print only "
+               "final stats\n";
+  std::cout << "  --convert        : Convert a text trace to the binary "
+               "format\n";
+  std::cout << "  --sweep          : Replay one binary trace through several "
+               "configurations\n"
+               "                     in parallel (see README)\n";
+}
+
+// --- Simulator State ---
 
-int main() {
-  // Subsystem Pointers
-  MemorySimulator *standard_mem = nullptr;
+// Everything a command can touch. Kept in one place so the interactive loop
+// and trace replay drive exactly the same code path.
+struct SimContext {
+  Allocator *memory = nullptr;
   CacheController *cache_system = nullptr;
   MMU *mmu_system = nullptr;
+  MultiCoreSystem *multicore = nullptr; // Takes accesses when set
+  bool quiet = false; // Suppress everything except final stats
+};
 
-  std::string command;
-  std::cout << "========================================\n";
-  std::cout << "   Memory & Cache Simulator Started\n";
-  std::cout << "========================================\n";
-  std::cout << "Type 'help' for commands.\n";
+void reset_context(SimContext &ctx) {
+  if (ctx.memory)
+    delete ctx.memory;
+  if (ctx.cache_system)
+    delete ctx.cache_system;
+  if (ctx.mmu_system)
+    delete ctx.mmu_system;
+  delete ctx.multicore;
+  ctx.memory = nullptr;
+  ctx.cache_system = nullptr;
+  ctx.mmu_system = nullptr;
+  ctx.multicore = nullptr;
+}
 
-  while (true) {
-    std::cout << "> ";
-    std::cin >> command;
+void print_final_stats(SimContext &ctx) {
+  if (ctx.memory)
+    ctx.memory->print_stats();
+  if (ctx.cache_system)
+    ctx.cache_system->dump_stats();
+  if (ctx.mmu_system)
+    ctx.mmu_system->print_stats();
+  if (ctx.multicore)
+    ctx.multicore->print_stats();
+  if (ctx.mmu_system)
+    ctx.mmu_system->print_latency();
+  else if (ctx.cache_system)
+    ctx.cache_system->print_latency();
+}
 
-    if (command == "exit")
-      break;
+// Reads an address or size in decimal or 0x-prefixed hex (see
+// parse_number; trace conversion reads numbers the same way).
+bool read_number(std::istream &in, unsigned long long &value) {
+  std::string token;
+  if (!(in >> token))
+    return false;
+  const char *end;
+  uint64_t parsed;
+  if (!parse_number(token.c_str(), end, parsed) || *end != '\0')
+    return false;
+  value = parsed;
+  return true;
+}
 
-    // --- HELP COMMANDS ---
-    else if (command == "help") {
-      std::string sub;
-      if (std::cin.peek() == ' ') {
-        std::cin >> sub;
-        if (sub == "standard")
-          print_standard_help();
-        else if (sub == "cache")
-          print_cache_help();
-        else if (sub == "mmu")
-          print_mmu_help();
-        else
-          print_generic_help();
-      } else {
+// Sizes are signed 64-bit inside the simulator; reports the ones that are not.
+bool fits_size(unsigned long long value) {
+  if (value <= (unsigned long long)std::numeric_limits<long long>::max())
+    return true;
+  std::cout << "Error: Size " << value << " is too large.\n";
+  return false;
+}
+
+// Sends one trace record down the same path as the equivalent command.
+void replay_record(const TraceRecord &record, SimContext &ctx) {
+  switch (record.op) {
+  case TRACE_READ:
+  case TRACE_WRITE:
+  case TRACE_IFETCH: {
+    bool is_write = (record.op == TRACE_WRITE);
+    bool is_ifetch = (record.op == TRACE_IFETCH);
+    if (ctx.multicore)
+      ctx.multicore->access(record.core, record.address, is_write);
+    else if (ctx.mmu_system) {
+      ctx.mmu_system->context_switch(record.pid);
+      ctx.mmu_system->access(record.address, is_write, is_ifetch, record.pc);
+    }
+    else if (ctx.cache_system)
+      ctx.cache_system->access(record.address, is_write, is_ifetch,
+                               record.pc);
+    break;
+  }
+  case TRACE_MALLOC:
+    if (ctx.memory)
+      ctx.memory->my_malloc(record.size);
+    break;
+  case TRACE_FREE:
+    if (ctx.memory)
+      ctx.memory->my_free((long long)record.address);
+    break;
+  }
+}
+
+int run_sweep(const std::string &path, unsigned threads);
+
+// Executes one command, reading its arguments from `in`.
+// Returns false when the command asks the simulator to stop.
+bool execute_command(const std::string &command, std::istream &in,
+                     SimContext &ctx) {
+  // Shorthand so the command bodies stay readable
+  Allocator *&memory = ctx.memory;
+  CacheController *&cache_system = ctx.cache_system;
+  MMU *&mmu_system = ctx.mmu_system;
+  bool verbose = !ctx.quiet;
+
+  if (command == "exit")
+    return false;
+
+  // --- COMMENTS (trace files) ---
+  else if (command[0] == '#') {
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+
+  // --- HELP COMMANDS ---
+  else if (command == "help") {
+    std::string sub;
+    if (in.peek() == ' ') {
+      in >> sub;
+      if (sub == "standard")
+        print_standard_help();
+      else if (sub == "buddy")
+        print_buddy_help();
+      else if (sub == "slab")
+        print_slab_help();
+      else if (sub == "cache")
+        print_cache_help();
+      else if (sub == "mmu")
+        print_mmu_help();
+      else
         print_generic_help();
-      }
+    } else {
+      print_generic_help();
     }
+  }
 
-    // --- MEMORY ALLOCATOR INIT ---
-    else if (command == "init") {
-      std::string type;
-      int size;
-      std::cin >> type >> size;
+  // --- MEMORY ALLOCATOR INIT ---
+  else if (command == "init") {
+    std::string type;
+    unsigned long long value = 0;
+    in >> type;
+    read_number(in, value);
+    if (!fits_size(value))
+      return true;
+    long long size = (long long)value;
 
-      // Cleanup old systems if re-initializing
-      if (standard_mem) {
-        delete standard_mem;
-        standard_mem = nullptr;
+    // Optional arguments run to the end of the line
+    std::string rest;
+    std::getline(in, rest);
+    std::istringstream options(rest);
+
+    // Check the arguments first so a bad command keeps the current system
+    unsigned long long slab_size = SlabAllocator::DEFAULT_SLAB_SIZE;
+    if (type == "slab") {
+      std::string token;
+      if (size <= 0) {
+        std::cout << "Error: Heap size must be positive.\n";
+        return true;
       }
-      if (cache_system) {
-        std::cout << "Note: Cache reset due to memory change.\n";
-        delete cache_system;
-        cache_system = nullptr;
+      if (options >> token) {
+        std::istringstream number(token);
+        if (!read_number(number, slab_size) ||
+            !SlabAllocator::valid_slab_size((long long)slab_size)) {
+          std::cout << "Error: Slab size must be a power of two of at least "
+                    << SlabAllocator::MIN_SLAB_SIZE << " bytes.\n";
+          return true;
+        }
       }
-      if (mmu_system) {
+    }
+
+    // Cleanup old systems if re-initializing
+    if (memory) {
+      delete memory;
+      memory = nullptr;
+    }
+    if (cache_system) {
+      if (verbose)
+        std::cout << "Note: Cache reset due to memory change.\n";
+      delete cache_system;
+      cache_system = nullptr;
+    }
+    if (mmu_system) {
+      if (verbose)
         std::cout << "Note: MMU reset due to memory change.\n";
-        delete mmu_system;
-        mmu_system = nullptr;
-      }
+      delete mmu_system;
+      mmu_system = nullptr;
+    }
+    if (ctx.multicore) {
+      if (verbose)
+        std::cout << "Note: Multi-core reset due to memory change.\n";
+      delete ctx.multicore;
+      ctx.multicore = nullptr;
+    }
 
-      if (type == "standard") {
-        standard_mem = new MemorySimulator(size);
-        std::cout << "Standard Allocator Initialized (" << size << " bytes).\n";
-      } else {
-        std::cout << "Unknown type. Use 'standard'.\n";
-      }
+    if (type == "standard") {
+      memory = new MemorySimulator(size);
+      memory->set_verbose(verbose);
+      if (verbose)
+        std::cout << "Standard Allocator Initialized (" << size
+                  << " bytes).\n";
+    } else if (type == "buddy") {
+      memory = new BuddyAllocator(size);
+      memory->set_verbose(verbose);
+      if (verbose)
+        std::cout << "Buddy Allocator Initialized (" << size << " bytes).\n";
+    } else if (type == "slab") {
+      memory = new SlabAllocator(size, (int)slab_size);
+      memory->set_verbose(verbose);
+      if (verbose)
+        std::cout << "Slab Allocator Initialized (" << size << " bytes).\n";
+    } else {
+      std::cout << "Unknown type. Use 'standard', 'buddy' or 'slab'.\n";
     }
+  }
 
-    // --- CACHE INIT ---
-    else if (command == "init_cache") {
-      int size, block_size, assoc;
-      if (std::cin >> size >> block_size >> assoc) {
-        if (cache_system)
-          delete cache_system;
+  // --- CACHE INIT ---
+  else if (command == "init_cache") {
+    unsigned long long value;
+    int block_size, assoc;
+    if (read_number(in, value) && in >> block_size >> assoc) {
+      if (!fits_size(value))
+        return true;
+      long long size = (long long)value;
+
+      // Optional replacement policies run to the end of the line
+      std::string rest, l1_name = "lru", l2_name;
+      std::getline(in, rest);
+      std::istringstream options(rest);
+      options >> l1_name;
+      if (!(options >> l2_name))
+        l2_name = l1_name;
 
-        // Create L1 (Size) and L2 (Size * 8)
-        CacheLevel *l1 = new CacheLevel(1, size, block_size, assoc);
-        CacheLevel *l2 = new CacheLevel(2, size * 8, block_size, assoc);
+      // Create L1 (Size) and L2 (Size * 8)
+      CacheLevel *l1 = create_cache_level(1, size, block_size, assoc, l1_name);
+      CacheLevel *l2 =
+          l1 ? create_cache_level(2, size * 8, block_size, assoc, l2_name)
+             : nullptr;
+      if (!l2) {
+        delete l1;
+        return true;
+      }
+
+      if (cache_system)
+        delete cache_system;
 
-        // Link Cache to currently active memory
-        cache_system = new CacheController(l1, l2, standard_mem);
+      // Link Cache to currently active memory
+      cache_system = new CacheController(l1, l2, memory);
+      cache_system->set_verbose(verbose);
+      if (mmu_system)
+        mmu_system->set_cache(cache_system); // Don't leave it on the old one
 
+      if (verbose) {
         std::cout << "Cache Initialized (L1: " << size << "B, L2: " << size * 8
                   << "B).\n";
-        if (standard_mem)
+        if (l1_name != "lru" || l2_name != "lru")
+          std::cout << "-> Replacement: L1 " << l1->policy_name() << ", L2 "
+                    << l2->policy_name() << ".\n";
+        if (memory)
           std::cout << "-> Linked to Active Memory.\n";
         else
           std::cout << "-> Warning: No Memory Initialized yet.\n";
+      }
 
-      } else {
-        std::cout << "Invalid arguments.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+
+  else if (command == "init_hierarchy") {
+    std::string path;
+    in >> path;
+    CacheController *hierarchy = load_cache_config(path, memory, verbose);
+    if (!hierarchy)
+      return true;
+
+    if (cache_system)
+      delete cache_system;
+    cache_system = hierarchy;
+    if (mmu_system)
+      mmu_system->set_cache(cache_system);
+
+    if (verbose) {
+      std::cout << "Cache Hierarchy Initialized (";
+      const char *sep = "";
+      for (CacheLevel *level : cache_system->get_levels()) {
+        std::cout << sep << level->get_name() << ": " << level->get_size()
+                  << "B";
+        sep = ", ";
       }
+      std::cout << ").\n";
+      if (memory)
+        std::cout << "-> Linked to Active Memory.\n";
+      else
+        std::cout << "-> Warning: No Memory Initialized yet.\n";
     }
+  }
 
-    // --- MMU INIT ---
-    else if (command == "init_mmu") {
-      int page_size;
-      if (std::cin >> page_size) {
-        if (!standard_mem) {
-          std::cout << "Error: Initialize memory (init standard) first.\n";
-        } else {
-          if (mmu_system)
-            delete mmu_system;
-          // Pass Cache and Memory to MMU
-          mmu_system = new MMU(page_size, cache_system, standard_mem);
+  // --- MMU INIT ---
+  else if (command == "init_mmu") {
+    unsigned long long page_size;
+    if (read_number(in, page_size)) {
+      std::string rest, policy = "lru";
+      std::getline(in, rest);
+      std::istringstream options(rest);
+      options >> policy;
+      PageReplacer *replacer = create_page_replacer(policy);
+      if (!replacer)
+        return true;
+      if (!memory) {
+        std::cout << "Error: Initialize memory (init standard|buddy) first.\n";
+        delete replacer;
+      } else {
+        if (mmu_system)
+          delete mmu_system;
+        // Pass Cache and Memory to MMU
+        mmu_system = new MMU((long long)page_size, cache_system, memory);
+        mmu_system->set_page_replacer(replacer);
+        mmu_system->set_verbose(verbose);
+        if (verbose) {
+          std::cout << "MMU Initialized with Page Size: " << page_size
+                    << " bytes\n";
           std::cout << "Virtual Addressing Enabled.\n";
         }
-      } else {
-        std::cout << "Invalid arguments.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
       }
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+  }
 
-    // --- DATA ACCESS COMMAND (The Hub) ---
-    else if (command == "access") {
-      int addr;
-      std::string type;
-      std::cin >> addr >> type;
-
-      if (type == "r")
-        type = "read";
-      if (type == "w")
-        type = "write";
-
-      if (mmu_system) {
-        // 1. Virtual Memory Mode
-        // Flow: User -> MMU -> Cache -> Memory
-        mmu_system->access(addr, type);
-      } else if (cache_system) {
-        // 2. Physical Cache Mode (Legacy)
-        // Flow: User -> Cache -> Memory
-        std::cout << "[Physical Access] ";
-        cache_system->access(addr, type);
-
-      } else {
-        std::cout << "Error: Neither MMU nor Cache is initialized.\n";
+  // --- TLB INIT ---
+  // init_tlb <dtlb_entries> <dtlb_ways> <stlb_entries> <stlb_ways> [policy]
+  else if (command == "init_tlb") {
+    int l1_entries, l1_ways, l2_entries, l2_ways;
+    if (in >> l1_entries >> l1_ways >> l2_entries >> l2_ways) {
+      std::string rest, policy = "lru";
+      int huge_entries = 0, huge_ways = 0;
+      std::getline(in, rest);
+      std::istringstream options(rest);
+      options >> policy >> huge_entries >> huge_ways;
+      if (!mmu_system) {
+        std::cout << "Error: Initialize the MMU (init_mmu) before the TLB.\n";
+        return true;
       }
+      TLB *tlb = create_tlb(l1_entries, l1_ways, l2_entries, l2_ways, policy,
+                            huge_entries, huge_ways);
+      if (!tlb)
+        return true;
+      mmu_system->set_tlb(tlb);
+      if (verbose) {
+        std::cout << "TLB Initialized (DTLB: " << l1_entries << " entries, "
+                  << l1_ways << "-way";
+        if (huge_entries > 0)
+          std::cout << "; huge DTLB: " << huge_entries << " entries, "
+                    << huge_ways << "-way";
+        if (l2_entries > 0)
+          std::cout << "; STLB: " << l2_entries << " entries, " << l2_ways
+                    << "-way";
+        std::cout << ").\n";
+      }
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+  }
 
-    // --- STATS & DUMPS ---
-    else if (command == "cache_stats") {
-      if (cache_system)
-        cache_system->dump_stats();
+  // --- PROCESSES ---
+  // switch <pid>: later accesses use pid's address space
+  else if (command == "switch") {
+    unsigned long long pid;
+    if (read_number(in, pid) && pid <= 0xFFFF) {
+      if (!mmu_system)
+        std::cout << "Error: MMU not initialized.\n";
       else
-        std::cout << "Cache not initialized.\n";
-    } else if (command == "pt_dump") {
-      if (mmu_system)
-        mmu_system->print_page_table();
-      else
-        std::cout << "MMU not initialized.\n";
+        mmu_system->context_switch((unsigned)pid);
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+  }
 
-    // --- MEMORY OPERATIONS ---
-    else if (command == "malloc") {
-      int size;
-      if (std::cin >> size) {
-        if (standard_mem)
-          standard_mem->my_malloc(size);
-        else
-          std::cout << "Error: System not initialized. Use 'init'.\n";
-      } else {
-        std::cout << "Invalid size.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  // --- HUGE PAGE REGION ---
+  // huge_region <v_addr> <length>: huge pages allowed here (madvise mode)
+  else if (command == "huge_region") {
+    unsigned long long va, length;
+    if (read_number(in, va) && read_number(in, length)) {
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+      } else if (!mmu_system->add_huge_region(va, length)) {
+        std::cout << "Error: Region holds no whole huge page.\n";
+      } else if (verbose) {
+        std::cout << "Huge pages allowed in [" << va << ", " << va + length
+                  << ").\n";
       }
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+  }
 
-    else if (command == "free") {
-      int val;
-      if (std::cin >> val) {
-        if (standard_mem)
-          standard_mem->my_free(val); // Val is ID
-        else
-          std::cout << "Error: System not initialized.\n";
-      } else {
-        std::cout << "Invalid input.\n";
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  // --- DATA ACCESS COMMAND (The Hub) ---
+  else if (command == "access") {
+    unsigned long long addr = 0, pc = 0, core = 0;
+    std::string type, rest;
+    if (!read_number(in, addr)) {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      return true;
+    }
+    in >> type;
+    std::getline(in, rest); // Optional PC (for prefetchers) and core
+    std::istringstream options(rest);
+    if (read_number(options, pc))
+      read_number(options, core);
+
+    bool is_write = (type == "w" || type == "write");
+    bool is_ifetch = (type == "x" || type == "exec"); // Goes to the L1I
+
+    if (ctx.multicore) {
+      // 0. Multi-Core Mode: addresses are physical
+      if (core >= (unsigned long long)ctx.multicore->num_cores()) {
+        std::cout << "Error: No core " << core << " (cores 0-"
+                  << ctx.multicore->num_cores() - 1 << ").\n";
+        return true;
       }
+      ctx.multicore->access((int)core, addr, is_write);
+    } else if (mmu_system) {
+      // 1. Virtual Memory Mode
+      // Flow: User -> MMU -> Cache -> Memory
+      mmu_system->access(addr, is_write, is_ifetch, pc);
+    } else if (cache_system) {
+      // 2. Physical Cache Mode (Legacy)
+      // Flow: User -> Cache -> Memory
+      if (verbose)
+        std::cout << "[Physical Access] ";
+      cache_system->access(addr, is_write, is_ifetch, pc);
+
+    } else if (verbose) {
+      std::cout << "Error: Neither MMU nor Cache is initialized.\n";
     }
+  }
 
-    else if (command == "dump") {
-      if (standard_mem)
-        standard_mem->dump_memory();
-      else
-        std::cout << "System not initialized.\n";
+  // --- BINARY TRACE REPLAY ---
+  else if (command == "replay") {
+    std::string path;
+    in >> path;
+    if (!mmu_system && !cache_system && !memory) {
+      std::cout << "Error: Initialize the system before replaying a trace.\n";
+      return true;
     }
 
-    else if (command == "stats") {
-      if (standard_mem)
-        standard_mem->print_stats();
-      else
-        std::cout << "System not initialized.\n";
+    TraceFile trace;
+    if (!trace.open(path))
+      return true;
+    for (const TraceRecord &record : trace)
+      replay_record(record, ctx);
+    if (verbose)
+      std::cout << "Replayed " << trace.size() << " records from '" << path
+                << "'.\n";
+  }
+
+  // convert <text|lackey|perf> <input> <output>: same as --convert, so
+  // command files can build the traces they replay
+  else if (command == "convert") {
+    std::string format, input, output;
+    if (in >> format >> input >> output) {
+      convert_trace(format, input, output);
+    } else {
+      std::cout << "Usage: convert <text|lackey|perf> <input> <output>\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+
+  // --- MISS RATIO CURVES ---
+  // mrc <trace.bin> <block> <max_size> [max_ways]: one pass, every size
+  else if (command == "mrc") {
+    std::string path;
+    unsigned long long block = 0, max_size = 0, max_ways = 16;
+    in >> path;
+    if (!read_number(in, block) || !read_number(in, max_size) || block == 0 ||
+        (block & (block - 1)) != 0) {
+      std::cout << "Usage: mrc <trace.bin> <block_size (power of two)> "
+                   "<max_size> [max_ways]\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      return true;
+    }
+    std::string rest;
+    std::getline(in, rest);
+    std::istringstream options(rest);
+    read_number(options, max_ways);
+    run_stack_distance(path, (int)block, max_size, (int)max_ways);
+  }
+
+  // --- MULTI-CORE ---
+  // init_multicore <cores> <l1_size> <block> <ways> [mesi|moesi] [llc_size]
+  else if (command == "init_multicore") {
+    unsigned long long cores, l1_size, block, ways, llc_size = 0;
+    if (read_number(in, cores) && read_number(in, l1_size) &&
+        read_number(in, block) && read_number(in, ways)) {
+      std::string rest, protocol = "mesi";
+      std::getline(in, rest);
+      std::istringstream options(rest);
+      options >> protocol;
+      read_number(options, llc_size);
+      if (protocol != "mesi" && protocol != "moesi") {
+        std::cout << "Error: Unknown protocol '" << protocol
+                  << "' (use mesi or moesi).\n";
+        return true;
+      }
+      if (llc_size == 0) {
+        // Default: twice the private L2s, rounded up to a power of two
+        llc_size = 1;
+        while (llc_size < cores * l1_size * 16)
+          llc_size <<= 1;
+      }
+      MultiCoreSystem *system = create_multicore(
+          (int)cores, l1_size, block, (int)ways, llc_size,
+          protocol == "moesi" ? COHERENCE_MOESI : COHERENCE_MESI, memory);
+      if (!system)
+        return true;
+      delete ctx.multicore;
+      ctx.multicore = system;
+      if (verbose)
+        std::cout << "Multi-Core Initialized (" << cores << " cores, "
+                  << protocol << ", L1: " << l1_size << "B, L2: " << l1_size * 8
+                  << "B, LLC: " << llc_size << "B).\n";
+    } else {
+      std::cout << "Invalid arguments.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+  } else if (command == "coherence_stats") {
+    unsigned long long top = 10;
+    std::string rest;
+    std::getline(in, rest);
+    std::istringstream options(rest);
+    read_number(options, top);
+    if (!verbose)
+      return true;
+    if (ctx.multicore)
+      ctx.multicore->print_stats((int)top);
+    else
+      std::cout << "Multi-core not initialized.\n";
+  }
+
+  // --- PREFETCHERS ---
+  // prefetch <level> <none|next-line|ip-stride|stream> [degree] [latency]
+  else if (command == "prefetch") {
+    std::string level, type, rest;
+    unsigned long long degree = 2, latency = 16;
+    in >> level >> type;
+    std::getline(in, rest);
+    std::istringstream options(rest);
+    if (read_number(options, degree))
+      read_number(options, latency);
+    if (!cache_system) {
+      std::cout << "Error: Cache not initialized.\n";
+      return true;
+    }
+    CacheLevel *target = cache_system->find_level(level);
+    Prefetcher *prefetcher = nullptr;
+    if (type != "none") {
+      if (!target) {
+        std::cout << "Error: No cache level '" << level << "'.\n";
+        return true;
+      }
+      prefetcher =
+          create_prefetcher(type, target->get_block_size(), (int)degree);
+      if (!prefetcher)
+        return true;
+    }
+    if (cache_system->set_prefetcher(level, prefetcher, (int)latency) &&
+        verbose)
+      std::cout << "Prefetcher for " << level << ": " << type << ".\n";
+  }
+
+  // --- SET-PARALLEL REPLAY ---
+  // shard_replay <trace.bin> <size> <block> <ways> [policy] [threads]
+  else if (command == "shard_replay") {
+    std::string path, rest, policy = "lru";
+    unsigned long long size = 0, block = 0, ways = 0, threads = 0;
+    in >> path;
+    if (!read_number(in, size) || !read_number(in, block) ||
+        !read_number(in, ways) || ways == 0 || size < block * ways) {
+      std::cout << "Usage: shard_replay <trace.bin> <size> <block> <ways> "
+                   "[policy] [threads]\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      return true;
+    }
+    std::getline(in, rest);
+    std::istringstream options(rest);
+    options >> policy;
+    read_number(options, threads);
+    run_sharded_replay(path, size, block, (int)ways, policy,
+                       (unsigned)threads);
+  }
+
+  // --- PARALLEL SWEEP ---
+  // sweep <sweep_file> [threads]
+  else if (command == "sweep") {
+    std::string path, rest;
+    unsigned long long threads = 0;
+    std::getline(in, rest);
+    std::istringstream options(rest);
+    options >> path;
+    read_number(options, threads);
+    if (path.empty())
+      std::cout << "Usage: sweep <sweep_file> [threads]\n";
+    else
+      run_sweep(path, (unsigned)threads);
+  }
 
-    else if (command == "set") {
-      std::string sub_cmd, strategy;
-      std::cin >> sub_cmd;
-      if (sub_cmd == "allocator") {
-        std::cin >> strategy;
-        if (standard_mem) {
-          if (strategy == "first")
-            standard_mem->set_strategy(FIRST_FIT);
-          else if (strategy == "best")
-            standard_mem->set_strategy(BEST_FIT);
-          else if (strategy == "worst")
-            standard_mem->set_strategy(WORST_FIT);
-          else
-            std::cout << "Unknown strategy.\n";
-        } else {
-          std::cout << "Command not available in current mode.\n";
+  // --- STATS & DUMPS ---
+  // Reports are skipped in quiet mode; final stats are printed at the end.
+  else if (command == "cache_stats") {
+    if (!verbose)
+      return true;
+    if (cache_system)
+      cache_system->dump_stats();
+    else
+      std::cout << "Cache not initialized.\n";
+  } else if (command == "pt_dump") {
+    if (!verbose)
+      return true;
+    if (mmu_system)
+      mmu_system->print_page_table();
+    else
+      std::cout << "MMU not initialized.\n";
+  } else if (command == "mmu_stats") {
+    if (!verbose)
+      return true;
+    if (mmu_system)
+      mmu_system->print_stats();
+    else
+      std::cout << "MMU not initialized.\n";
+  } else if (command == "latency_stats") {
+    if (!verbose)
+      return true;
+    if (mmu_system)
+      mmu_system->print_latency();
+    else if (cache_system)
+      cache_system->print_latency();
+    else
+      std::cout << "Cache not initialized.\n";
+  }
+
+  // --- MEMORY OPERATIONS ---
+  else if (command == "malloc") {
+    unsigned long long size;
+    if (read_number(in, size)) {
+      if (!fits_size(size))
+        return true;
+      if (memory)
+        memory->my_malloc((long long)size);
+      else if (verbose)
+        std::cout << "Error: System not initialized. Use 'init'.\n";
+    } else {
+      std::cout << "Invalid size.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+
+  else if (command == "free") {
+    unsigned long long val;
+    if (read_number(in, val)) {
+      if (memory)
+        memory->my_free((long long)val); // Val is the block's address
+      else if (verbose)
+        std::cout << "Error: System not initialized.\n";
+    } else {
+      std::cout << "Invalid input.\n";
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+
+  else if (command == "dump") {
+    if (!verbose)
+      return true;
+    if (memory)
+      memory->dump_memory();
+    else
+      std::cout << "System not initialized.\n";
+  }
+
+  else if (command == "stats") {
+    if (!verbose)
+      return true;
+    if (memory)
+      memory->print_stats();
+    else
+      std::cout << "System not initialized.\n";
+  }
+
+  else if (command == "set") {
+    std::string sub_cmd, strategy;
+    in >> sub_cmd;
+    if (sub_cmd == "allocator") {
+      in >> strategy;
+      // Placement strategies only apply to the linked-list allocator
+      MemorySimulator *list_mem = dynamic_cast<MemorySimulator *>(memory);
+      if (list_mem) {
+        if (strategy == "first")
+          list_mem->set_strategy(FIRST_FIT);
+        else if (strategy == "best")
+          list_mem->set_strategy(BEST_FIT);
+        else if (strategy == "worst")
+          list_mem->set_strategy(WORST_FIT);
+        else
+          std::cout << "Unknown strategy.\n";
+      } else {
+        std::cout << "Command not available in current mode.\n";
+      }
+    } else if (sub_cmd == "walk_cache") {
+      // set walk_cache <on|off>: replay page-walk reads through the cache
+      std::string mode;
+      in >> mode;
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+      } else if (mode == "on" || mode == "off") {
+        mmu_system->set_walk_to_cache(mode == "on");
+        if (verbose)
+          std::cout << "Page-walk cache traffic " << mode << ".\n";
+      } else {
+        std::cout << "Usage: set walk_cache <on|off>\n";
+      }
+    } else if (sub_cmd == "huge_pages") {
+      // set huge_pages <never|always|madvise>
+      std::string mode;
+      in >> mode;
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+      } else if (mode == "never" || mode == "always" || mode == "madvise") {
+        mmu_system->set_huge_pages(mode == "never"    ? HUGE_NEVER
+                                   : mode == "always" ? HUGE_ALWAYS
+                                                      : HUGE_MADVISE);
+        if (verbose)
+          std::cout << "Huge pages: " << mode << ".\n";
+      } else {
+        std::cout << "Usage: set huge_pages <never|always|madvise>\n";
+      }
+    } else if (sub_cmd == "page_replacement") {
+      // set page_replacement <policy>: resident pages carry over
+      std::string policy;
+      in >> policy;
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+        return true;
+      }
+      PageReplacer *replacer = create_page_replacer(policy);
+      if (replacer) {
+        mmu_system->set_page_replacer(replacer);
+        if (verbose)
+          std::cout << "Page replacement: " << replacer->name() << ".\n";
+      }
+    } else if (sub_cmd == "latency") {
+      // set latency <L1|L2|...|memory|dtlb|stlb|walk|fault> <cycles>
+      std::string target;
+      unsigned long long cycles;
+      in >> target;
+      if (!read_number(in, cycles) || cycles > 1000000000ULL) {
+        std::cout << "Usage: set latency <level|memory|dtlb|stlb|walk|fault> "
+                     "<cycles>\n";
+        in.clear();
+        in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        return true;
+      }
+      bool applied = false;
+      if (target == "memory" || target == "dram") {
+        if (cache_system)
+          cache_system->set_memory_latency((int)cycles);
+        if (mmu_system)
+          mmu_system->set_memory_latency((int)cycles);
+        applied = cache_system || mmu_system;
+      } else if (target == "walk" || target == "fault") {
+        if (mmu_system && target == "walk")
+          mmu_system->set_walk_latency((int)cycles);
+        else if (mmu_system)
+          mmu_system->set_fault_latency((long long)cycles);
+        applied = mmu_system != nullptr;
+      } else if (target == "dtlb" || target == "stlb") {
+        applied = mmu_system && mmu_system->set_tlb_latency(target, (int)cycles);
+      } else if (CacheLevel *level =
+                     cache_system ? cache_system->find_level(target)
+                                  : nullptr) {
+        level->set_latency((int)cycles);
+        applied = true;
+      }
+      if (!applied)
+        std::cout << "Error: No '" << target << "' in the current system.\n";
+      else if (verbose)
+        std::cout << "Latency of " << target << ": " << cycles
+                  << " cycles.\n";
+    } else if (sub_cmd == "page_scope") {
+      // set page_scope <global|local>: whose pages a fault may evict
+      std::string mode;
+      in >> mode;
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+      } else if (mode == "global" || mode == "local") {
+        mmu_system->set_replacement_scope(mode == "global" ? SCOPE_GLOBAL
+                                                           : SCOPE_LOCAL);
+        if (verbose)
+          std::cout << "Page replacement scope: " << mode << ".\n";
+      } else {
+        std::cout << "Usage: set page_scope <global|local>\n";
+      }
+    } else if (sub_cmd == "asid") {
+      // set asid <on|off>: off flushes the TLB on every context switch
+      std::string mode;
+      in >> mode;
+      if (!mmu_system) {
+        std::cout << "Error: MMU not initialized.\n";
+      } else if (mode == "on" || mode == "off") {
+        mmu_system->set_asids(mode == "on");
+        if (verbose)
+          std::cout << "ASID-tagged TLB " << mode << ".\n";
+      } else {
+        std::cout << "Usage: set asid <on|off>\n";
+      }
+    } else if (sub_cmd == "write_policy") {
+      // set write_policy <level|all> <write-back|write-through>
+      //                  [write-allocate|no-write-allocate]
+      std::string target, hit_mode, rest, miss_mode = "write-allocate";
+      in >> target >> hit_mode;
+      std::getline(in, rest);
+      std::istringstream options(rest);
+      options >> miss_mode;
+      if (!cache_system) {
+        std::cout << "Error: Cache not initialized.\n";
+        return true;
+      }
+      if ((hit_mode != "write-back" && hit_mode != "write-through") ||
+          (miss_mode != "write-allocate" && miss_mode != "no-write-allocate")) {
+        std::cout << "Usage: set write_policy <level|all> "
+                     "<write-back|write-through> "
+                     "[write-allocate|no-write-allocate]\n";
+        return true;
+      }
+      bool wb = hit_mode == "write-back";
+      bool wa = miss_mode == "write-allocate";
+      bool found = false;
+      for (CacheLevel *level : cache_system->get_levels()) {
+        if (target == "all" || level == cache_system->find_level(target)) {
+          level->set_write_policy(wb, wa);
+          found = true;
         }
       }
+      if (!found)
+        std::cout << "Error: No cache level '" << target << "'.\n";
+      else if (verbose)
+        std::cout << "Write policy for " << target << ": " << hit_mode << ", "
+                  << miss_mode << ".\n";
     }
+  }
+
+  else {
+    std::cout << "Unknown command. Type 'help'.\n";
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+
+  return true;
+}
+
+// --- Batch Mode ---
+
+// Streams a command file through the simulator without prompts.
+int run_trace(const std::string &path, bool quiet) {
+  std::ifstream trace(path);
+  if (!trace) {
+    std::cout << "Error: Cannot open trace file '" << path << "'.\n";
+    return 1;
+  }
+
+  SimContext ctx;
+  ctx.quiet = quiet;
+
+  std::string command;
+  while (trace >> command) {
+    if (!execute_command(command, trace, ctx))
+      break;
+  }
 
-    else {
-      std::cout << "Unknown command. Type 'help'.\n";
-      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  print_final_stats(ctx);
+  reset_context(ctx);
+  return 0;
+}
+
+// --- Parallel Sweep ---
+
+// One configuration of a sweep: setup commands, then the shared trace
+struct SweepConfig {
+  std::string name;
+  std::string commands; // ';'-separated, as typed at the prompt
+};
+
+struct SweepResult {
+  bool ok = false;
+  std::vector<std::pair<std::string, double>> hit_rates; // Per cache level
+  long long page_faults = -1;                             // -1 = no MMU
+  long long invalid_accesses = 0;
+  double seconds = 0;
+};
+
+// Sets up a private SimContext for config, replays the records into it and
+// records the results. Safe to run concurrently: contexts share nothing
+// but the read-only trace.
+void run_sweep_config(const SweepConfig &config, const TraceFile &trace,
+                      SweepResult &result) {
+  auto start = std::chrono::steady_clock::now();
+  SimContext ctx;
+  ctx.quiet = true;
+
+  std::string script = config.commands;
+  for (char &c : script) {
+    if (c == ';')
+      c = '\n';
+  }
+  std::istringstream setup(script);
+  std::string command;
+  while (setup >> command) {
+    if (!execute_command(command, setup, ctx))
+      break;
+  }
+
+  if (ctx.cache_system || ctx.mmu_system) {
+    for (const TraceRecord &record : trace)
+      replay_record(record, ctx);
+    result.ok = true;
+  }
+
+  if (ctx.cache_system) {
+    for (CacheLevel *level : ctx.cache_system->get_levels()) {
+      long long total = level->get_hits() + level->get_misses();
+      double rate = total ? (double)level->get_hits() / total * 100.0 : 0.0;
+      result.hit_rates.push_back({level->get_name(), rate});
     }
+    result.invalid_accesses = ctx.cache_system->get_invalid_accesses();
   }
+  if (ctx.mmu_system)
+    result.page_faults = ctx.mmu_system->get_page_faults();
+  reset_context(ctx);
 
-  // Cleanup
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+}
+
+// Sweep file:
+//   trace <file.trc>
+//   config <name> <command>; <command>; ...
+// Runs every config on a pool of worker threads and prints a table.
+int run_sweep(const std::string &path, unsigned threads) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cout << "Error: Cannot open sweep file '" << path << "'.\n";
+    return 1;
+  }
 
-  if (standard_mem)
-    delete standard_mem;
-  if (cache_system)
-    delete cache_system;
-  if (mmu_system)
-    delete mmu_system;
+  std::string trace_path, line;
+  std::vector<SweepConfig> configs;
+  while (std::getline(file, line)) {
+    std::istringstream words(line);
+    std::string keyword;
+    if (!(words >> keyword) || keyword[0] == '#')
+      continue;
+    if (keyword == "trace") {
+      words >> trace_path;
+    } else if (keyword == "config") {
+      SweepConfig config;
+      words >> config.name;
+      std::getline(words, config.commands);
+      configs.push_back(config);
+    } else {
+      std::cout << "Error: Unknown sweep line '" << line << "'.\n";
+      return 1;
+    }
+  }
+  if (trace_path.empty() || configs.empty()) {
+    std::cout << "Error: A sweep needs a 'trace' line and at least one "
+                 "'config' line.\n";
+    return 1;
+  }
 
+  // Decoded (mapped) once, read by every worker
+  TraceFile trace;
+  if (!trace.open(trace_path))
+    return 1;
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  if (threads > configs.size())
+    threads = (unsigned)configs.size();
+
+  std::vector<SweepResult> results(configs.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&] {
+    for (size_t i = next++; i < configs.size(); i = next++)
+      run_sweep_config(configs[i], trace, results[i]);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; t++)
+    pool.emplace_back(worker);
+  for (std::thread &t : pool)
+    t.join();
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::cout << "--- Sweep Results (" << trace.size() << " records, "
+            << configs.size() << " configs, " << threads << " threads, "
+            << std::fixed << std::setprecision(2) << elapsed << " s) ---\n";
+  std::cout << std::left << std::setw(16) << "Config" << std::right
+            << std::setw(9) << "Time(s)" << std::setw(12) << "PageFaults"
+            << std::setw(10) << "Invalid" << "  Hit Rates\n";
+  for (size_t i = 0; i < configs.size(); i++) {
+    const SweepResult &r = results[i];
+    std::cout << std::left << std::setw(16) << configs[i].name << std::right;
+    if (!r.ok) {
+      std::cout << "  (setup failed: no cache or MMU)\n";
+      continue;
+    }
+    std::cout << std::setw(9) << r.seconds << std::setw(12)
+              << (r.page_faults < 0 ? std::string("-")
+                                    : std::to_string(r.page_faults))
+              << std::setw(10) << r.invalid_accesses << " ";
+    for (const auto &level : r.hit_rates)
+      std::cout << " " << level.first << " " << level.second << "%";
+    std::cout << "\n";
+  }
   return 0;
-}
\ No newline at end of file
+}
+
+// --- Main Function ---
+
+int main(int argc, char *argv[]) {
+  std::string trace_path;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--trace" && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (arg == "--quiet") {
+      quiet = true;
+    } else if (arg == "--convert" && i + 3 < argc) {
+      return convert_trace(argv[i + 1], argv[i + 2], argv[i + 3]) ? 0 : 1;
+    } else if (arg == "--sweep" && i + 1 < argc) {
+      unsigned threads =
+          (i + 2 < argc) ? (unsigned)std::strtoul(argv[i + 2], nullptr, 10) : 0;
+      return run_sweep(argv[i + 1], threads);
+    } else {
+      print_usage();
+      return 1;
+    }
+  }
+
+  if (!trace_path.empty())
+    return run_trace(trace_path, quiet);
+
+  SimContext ctx;
+  ctx.quiet = quiet;
+
+  std::string command;
+  std::cout << "========================================\n";
+  std::cout << "   Memory & Cache Simulator Started\n";
+  std::cout << "========================================\n";
+  std::cout << "Type 'help' for commands.\n";
+
+  while (true) {
+    std::cout << "> ";
+    if (!(std::cin >> command))
+      break;
+    if (!execute_command(command, std::cin, ctx))
+      break;
+  }
+
+  // Cleanup
+  reset_context(ctx);
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include "../../include/Trace.h"
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#define TRACE_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char TRACE_MAGIC[8] = {'M', 'E', 'M', 'T', 'R', 'A', 'C', 'E'};
+
+// --- TraceFile Implementation ---
+
+TraceFile::~TraceFile() {
+    close();
+}
+
+// Validates the header against the file length. Returns the record count, or
+// -1 if the data is not a trace we can read.
+static long long check_header(const TraceHeader& header, size_t file_size,
+                              const std::string& path) {
+    if (std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        std::cout << "Error: '" << path << "' is not a binary trace.\n";
+        return -1;
+    }
+    if (header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        std::cout << "Error: '" << path << "' has unsupported trace version "
+                  << header.version << ".\n";
+        return -1;
+    }
+    size_t available = (file_size - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    if (header.record_count > available) {
+        std::cout << "Warning: '" << path << "' is truncated, replaying "
+                  << available << " of " << header.record_count << " records.\n";
+        return (long long)available;
+    }
+    return (long long)header.record_count;
+}
+
+bool TraceFile::open(const std::string& path) {
+    close();
+
+#ifndef TRACE_NO_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "Error: Cannot open trace file '" << path << "'.\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceHeader)) {
+        std::cout << "Error: '" << path << "' is not a binary trace.\n";
+        ::close(fd);
+        return false;
+    }
+
+    size_t length = (size_t)st.st_size;
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (base == MAP_FAILED) {
+        std::cout << "Error: Cannot map trace file '" << path << "'.\n";
+        return false;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+
+    long long n = check_header(*static_cast<const TraceHeader*>(base), length, path);
+    if (n < 0) {
+        munmap(base, length);
+        return false;
+    }
+
+    map_base = base;
+    map_length = length;
+    records = reinterpret_cast<const TraceRecord*>(
+        static_cast<const char*>(base) + sizeof(TraceHeader));
+    count = (size_t)n;
+#else
+    // No mmap: read the whole file once, then serve records from memory
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        std::cout << "Error: Cannot open trace file '" << path << "'.\n";
+        return false;
+    }
+    size_t length = (size_t)in.tellg();
+    in.seekg(0);
+
+    TraceHeader header;
+    if (length < sizeof(TraceHeader) || !in.read((char*)&header, sizeof(header))) {
+        std::cout << "Error: '" << path << "' is not a binary trace.\n";
+        return false;
+    }
+    long long n = check_header(header, length, path);
+    if (n < 0) return false;
+
+    buffer.resize((size_t)n);
+    in.read((char*)buffer.data(), (std::streamsize)(n * sizeof(TraceRecord)));
+    records = buffer.data();
+    count = (size_t)n;
+#endif
+    return true;
+}
+
+void TraceFile::close() {
+#ifndef TRACE_NO_MMAP
+    if (map_base) munmap(map_base, map_length);
+#endif
+    map_base = nullptr;
+    map_length = 0;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    records = nullptr;
+    count = 0;
+}
+
+// --- TraceWriter Implementation ---
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+bool TraceWriter::open(const std::string& path) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cout << "Error: Cannot create trace file '" << path << "'.\n";
+        return false;
+    }
+    count = 0;
+
+    // Placeholder header; the record count is filled in by close()
+    TraceHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    out.write((const char*)&header, sizeof(header));
+    return true;
+}
+
+void TraceWriter::write(const TraceRecord& record) {
+    out.write((const char*)&record, sizeof(record));
+    count++;
+}
+
+void TraceWriter::close() {
+    if (!out.is_open()) return;
+
+    out.seekp(offsetof(TraceHeader, record_count));
+    out.write((const char*)&count, sizeof(count));
+    out.close();
+}
@@ -0,0 +1,245 @@
+#include "../../include/Trace.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// --- Line Parsers ---
+// Each parser appends zero or more records for one input line and returns
+// false if the line is not part of the trace (headers, unknown commands).
+
+static const char* skip_spaces(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == ',') p++;
+    return p;
+}
+
+static TraceRecord make_record(uint64_t address, uint8_t op) {
+    TraceRecord r{};
+    r.address = address;
+    r.op = op;
+    return r;
+}
+
+bool parse_number(const char* p, const char*& end, uint64_t& value) {
+    end = p;
+    int base = 10;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && std::isxdigit((unsigned char)p[2])) {
+        base = 16;
+        p += 2;
+    } else if (!std::isdigit((unsigned char)*p)) {
+        return false; // Also rules out strtoull's own sign and space handling
+    }
+    errno = 0;
+    char* stop;
+    value = std::strtoull(p, &stop, base);
+    if (errno == ERANGE) return false;
+    end = stop;
+    return true;
+}
+
+// The text after `word` at p if p starts with it as a whole word, else null.
+static const char* match_word(const char* p, const char* word) {
+    size_t n = std::strlen(word);
+    if (std::strncmp(p, word, n) != 0) return nullptr;
+    char next = p[n];
+    return (next == '\0' || next == ' ' || next == '\t' || next == '\r' || next == '\n') ? p + n : nullptr;
+}
+
+// Simulator command files: "access <addr> <r|w|x> [pc] [core]", "malloc <size>", "free <addr>".
+// "switch <pid>" tags the records after it with that process ID.
+static bool parse_text_line(const char* p, std::vector<TraceRecord>& out, uint16_t& pid) {
+    p = skip_spaces(p);
+    const char* end;
+    uint64_t value;
+
+    const char* rest;
+    if ((rest = match_word(p, "access"))) {
+        if (!parse_number(skip_spaces(rest), end, value)) return false;
+        p = skip_spaces(end);
+        // Same op words as the interactive command; no op means a read
+        uint8_t op = TRACE_READ;
+        rest = p;
+        if (*p != '\0' && *p != '\r' && *p != '\n') {
+            if ((rest = match_word(p, "r")) || (rest = match_word(p, "read"))) op = TRACE_READ;
+            else if ((rest = match_word(p, "w")) || (rest = match_word(p, "write"))) op = TRACE_WRITE;
+            else if ((rest = match_word(p, "x")) || (rest = match_word(p, "exec"))) op = TRACE_IFETCH;
+            else return false;
+        }
+        TraceRecord r = make_record(value, op);
+        if (parse_number(skip_spaces(rest), end, value)) {
+            r.pc = value;
+            if (parse_number(skip_spaces(end), end, value)) {
+                if (value > 255) {
+                    std::cout << "Error: Core " << value << " does not fit a trace record (0-255).\n";
+                    return false;
+                }
+                r.core = (uint8_t)value;
+            }
+        }
+        r.pid = pid;
+        out.push_back(r);
+        return true;
+    }
+    if ((rest = match_word(p, "malloc"))) {
+        if (!parse_number(skip_spaces(rest), end, value)) return false;
+        if (value > UINT32_MAX) {
+            std::cout << "Error: malloc size " << value << " does not fit a trace record (max "
+                      << UINT32_MAX << ").\n";
+            return false;
+        }
+        TraceRecord r = make_record(0, TRACE_MALLOC);
+        r.size = (uint32_t)value;
+        r.pid = pid;
+        out.push_back(r);
+        return true;
+    }
+    if ((rest = match_word(p, "free"))) {
+        if (!parse_number(skip_spaces(rest), end, value)) return false;
+        TraceRecord r = make_record(value, TRACE_FREE);
+        r.pid = pid;
+        out.push_back(r);
+        return true;
+    }
+    if ((rest = match_word(p, "switch"))) {
+        if (!parse_number(skip_spaces(rest), end, value)) return false;
+        if (value > 0xFFFF) {
+            std::cout << "Error: PID " << value << " does not fit a trace record (0-65535).\n";
+            return false;
+        }
+        pid = (uint16_t)value;
+        return true;
+    }
+    return false;
+}
+
+// valgrind --tool=lackey --trace-mem=yes:
+//   "I  0400d7d4,8"   instruction fetch
+//   " L 04222cac,4"   load
+//   " S 7ff000398,8"  store
+//   " M 0421ffe8,4"   modify (load followed by store)
+// Data accesses inherit the PC of the preceding instruction fetch.
+static bool parse_lackey_line(const char* p, std::vector<TraceRecord>& out,
+                              uint64_t& last_pc) {
+    p = skip_spaces(p);
+    char kind = *p;
+    if (kind != 'I' && kind != 'L' && kind != 'S' && kind != 'M') return false;
+
+    char* end;
+    const char* num = skip_spaces(p + 1);
+    uint64_t addr = std::strtoull(num, &end, 16);
+    if (end == num) return false;
+    uint32_t size = (*end == ',') ? (uint32_t)std::strtoul(end + 1, nullptr, 10) : 0;
+
+    TraceRecord r = make_record(addr, TRACE_READ);
+    r.size = size;
+    if (kind == 'I') {
+        last_pc = addr;
+        r.op = TRACE_IFETCH;
+        r.pc = addr;
+        out.push_back(r);
+        return true;
+    }
+
+    r.pc = last_pc;
+    if (kind == 'S') r.op = TRACE_WRITE;
+    out.push_back(r);
+    if (kind == 'M') {
+        r.op = TRACE_WRITE;
+        out.push_back(r);
+    }
+    return true;
+}
+
+// perf mem report -D:
+//   "PID TID IP ADDR [PHYS_ADDR] LOCAL_WEIGHT DSRC SYMBOL"
+// Hex fields carry a 0x prefix: the first is the IP, the second the data
+// address and the last the data source, whose low bits encode the operation.
+static bool parse_perf_line(const char* p, std::vector<TraceRecord>& out) {
+    p = skip_spaces(p);
+    if (!std::isdigit((unsigned char)*p)) return false; // Header or comment
+
+    char* end;
+    uint64_t pid = std::strtoull(p, &end, 10);
+
+    uint64_t hex[4] = {0, 0, 0, 0};
+    int n_hex = 0;
+    uint64_t dsrc = 0;
+    p = end;
+    while (*p != '\0') {
+        p = skip_spaces(p);
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            uint64_t v = std::strtoull(p, &end, 16);
+            if (n_hex < 4) hex[n_hex] = v;
+            n_hex++;
+            dsrc = v;
+        } else {
+            std::strtoull(p, &end, 10);
+            if (end == p) { // Symbol column: stop scanning
+                break;
+            }
+        }
+        p = end;
+    }
+    if (n_hex < 2) return false;
+
+    // PERF_MEM_OP_* bits: LOAD=0x2, STORE=0x4, EXEC=0x10
+    uint8_t op = TRACE_READ;
+    if (n_hex >= 3) {
+        if (dsrc & 0x4) op = TRACE_WRITE;
+        else if (dsrc & 0x10) op = TRACE_IFETCH;
+    }
+
+    TraceRecord r = make_record(hex[1], op);
+    r.pc = hex[0];
+    r.pid = (uint16_t)pid;
+    out.push_back(r);
+    return true;
+}
+
+// --- Converter ---
+
+bool convert_trace(const std::string& format, const std::string& in_path,
+                   const std::string& out_path) {
+    if (format != "text" && format != "lackey" && format != "perf") {
+        std::cout << "Error: Unknown trace format '" << format
+                  << "'. Use text, lackey or perf.\n";
+        return false;
+    }
+
+    std::ifstream in(in_path);
+    if (!in) {
+        std::cout << "Error: Cannot open '" << in_path << "'.\n";
+        return false;
+    }
+
+    TraceWriter writer;
+    if (!writer.open(out_path)) return false;
+
+    std::string line;
+    std::vector<TraceRecord> records;
+    uint64_t last_pc = 0;
+    uint16_t pid = 0;
+    long long skipped = 0;
+
+    while (std::getline(in, line)) {
+        records.clear();
+        const char* p = line.c_str();
+        bool ok;
+        if (format == "text") ok = parse_text_line(p, records, pid);
+        else if (format == "lackey") ok = parse_lackey_line(p, records, last_pc);
+        else ok = parse_perf_line(p, records);
+
+        if (!ok) {
+            skipped++;
+            continue;
+        }
+        for (const TraceRecord& r : records) writer.write(r);
+    }
+
+    std::cout << "Converted " << writer.records_written() << " records to '"
+              << out_path << "' (" << skipped << " lines skipped).\n";
+    writer.close();
+    return true;
+}
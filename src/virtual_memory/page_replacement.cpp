@@ -0,0 +1,103 @@
+#include "../../include/PageReplacement.h"
+#include <iostream>
+
+// --- PageReplacer ---
+
+void PageReplacer::add(unsigned long long vpn, PageTableEntry* pte, int owner) {
+    int slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        slot = (int)frames.size();
+        frames.push_back(Frame());
+    }
+    Frame& fr = frames[slot];
+    fr.vpn = vpn;
+    fr.pte = pte;
+    fr.owner = owner;
+    fr.prev = fr.next = -1;
+    fr.spared = false;
+    pte->slot = slot;
+    resident++;
+    link(slot);
+}
+
+bool PageReplacer::evict(unsigned long long& vpn, PageTableEntry*& pte, int& owner) {
+    if (resident == 0) return false;
+    int slot = victim();
+    Frame& fr = frames[slot];
+    unlink(slot);
+    vpn = fr.vpn;
+    pte = fr.pte;
+    owner = fr.owner;
+    pte->slot = -1;
+    fr.pte = nullptr;
+    free_slots.push_back(slot);
+    resident--;
+    return true;
+}
+
+// --- LRU ---
+
+void LRUPageReplacer::link(int slot) {
+    Frame& fr = frames[slot];
+    fr.prev = -1;
+    fr.next = head;
+    if (head != -1) frames[head].prev = slot;
+    head = slot;
+    if (tail == -1) tail = slot;
+}
+
+void LRUPageReplacer::unlink(int slot) {
+    Frame& fr = frames[slot];
+    if (fr.prev != -1) frames[fr.prev].next = fr.next;
+    else head = fr.next;
+    if (fr.next != -1) frames[fr.next].prev = fr.prev;
+    else tail = fr.prev;
+    fr.prev = fr.next = -1;
+}
+
+// --- CLOCK ---
+
+int ClockPageReplacer::victim() {
+    for (;;) {
+        if (hand >= frames.size()) hand = 0;
+        Frame& fr = frames[hand++];
+        if (!fr.pte) continue; // Free slot
+        if (fr.pte->referenced) {
+            fr.pte->referenced = false; // Second chance
+            continue;
+        }
+        return (int)(hand - 1);
+    }
+}
+
+int EnhancedClockPageReplacer::victim() {
+    for (;;) {
+        if (hand >= frames.size()) hand = 0;
+        Frame& fr = frames[hand++];
+        if (!fr.pte) continue;
+        if (fr.pte->referenced) {
+            fr.pte->referenced = false;
+            fr.spared = false;
+            continue;
+        }
+        if (fr.pte->dirty && !fr.spared) {
+            fr.spared = true; // Let clean pages go first
+            continue;
+        }
+        return (int)(hand - 1);
+    }
+}
+
+// --- Factory ---
+
+PageReplacer* create_page_replacer(const std::string& name) {
+    if (name == "lru") return new LRUPageReplacer();
+    if (name == "clock" || name == "second-chance") return new ClockPageReplacer();
+    if (name == "enhanced-clock") return new EnhancedClockPageReplacer();
+    std::cout << "Error: Unknown page replacement policy '" << name
+              << "' (use lru, clock, second-chance or enhanced-clock).\n";
+    return nullptr;
+}
@@ -0,0 +1,85 @@
+#include "../../include/PageTable.h"
+
+PageTable::PageTable(unsigned long long table_base) : base(table_base) { root = new_node(0); }
+
+std::unique_ptr<PageTable::Node> PageTable::new_node(int level) {
+    std::unique_ptr<Node> node(new Node());
+    node->phys_addr = base + (unsigned long long)tables * ENTRIES * ENTRY_BYTES;
+    if (level == LEVELS - 1) node->entries.resize(ENTRIES);
+    else node->child.resize(ENTRIES);
+    tables++;
+    return node;
+}
+
+const char* PageTable::level_name(int level) {
+    static const char* const names[LEVELS] = {"PML4", "PDPT", "PD", "PT"};
+    return names[level];
+}
+
+PageTableEntry* PageTable::walk(unsigned long long vpn, unsigned long long* ref_addrs, int& refs) {
+    refs = 0;
+    if (!in_range(vpn)) return nullptr;
+    Node* node = root.get();
+    for (int level = 0; level < LEVELS; level++) {
+        int idx = index_at(vpn, level);
+        level_refs[level]++;
+        if (ref_addrs) ref_addrs[refs] = node->phys_addr + (unsigned long long)idx * ENTRY_BYTES;
+        refs++;
+        if (level == LEVELS - 1) return &node->entries[idx];
+        if (!node->entries.empty() && node->entries[idx].valid) return &node->entries[idx]; // Huge page
+        node = node->child[idx].get();
+        if (!node) return nullptr; // Not present at this level
+    }
+    return nullptr;
+}
+
+const PageTable::Node* PageTable::pd_node(unsigned long long vpn) const {
+    if (!in_range(vpn)) return nullptr;
+    const Node* node = root.get();
+    for (int level = 0; level < LEVELS - 2 && node; level++) node = node->child[index_at(vpn, level)].get();
+    return node;
+}
+
+PageTableEntry* PageTable::find(unsigned long long vpn) const {
+    const Node* node = pd_node(vpn);
+    if (!node) return nullptr;
+    int idx = index_at(vpn, LEVELS - 2);
+    if (!node->entries.empty() && node->entries[idx].valid) return const_cast<PageTableEntry*>(&node->entries[idx]);
+    node = node->child[idx].get();
+    if (!node) return nullptr;
+    return const_cast<PageTableEntry*>(&node->entries[index_at(vpn, LEVELS - 1)]);
+}
+
+PageTableEntry& PageTable::map(unsigned long long vpn) {
+    Node* node = root.get();
+    for (int level = 0; level < LEVELS - 1; level++) {
+        std::unique_ptr<Node>& next = node->child[index_at(vpn, level)];
+        if (!next) next = new_node(level + 1);
+        node = next.get();
+    }
+    return node->entries[index_at(vpn, LEVELS - 1)];
+}
+
+PageTableEntry& PageTable::map_huge(unsigned long long vpn) {
+    Node* node = root.get();
+    for (int level = 0; level < LEVELS - 2; level++) {
+        std::unique_ptr<Node>& next = node->child[index_at(vpn, level)];
+        if (!next) next = new_node(level + 1);
+        node = next.get();
+    }
+    if (node->entries.empty()) node->entries.resize(ENTRIES); // Stays put once allocated
+    PageTableEntry& entry = node->entries[index_at(vpn, LEVELS - 2)];
+    entry.huge = true;
+    return entry;
+}
+
+bool PageTable::has_base_pages(unsigned long long vpn) const {
+    const Node* node = pd_node(vpn);
+    if (!node) return false;
+    node = node->child[index_at(vpn, LEVELS - 2)].get();
+    if (!node) return false;
+    for (const PageTableEntry& entry : node->entries) {
+        if (entry.valid) return true;
+    }
+    return false;
+}
@@ -0,0 +1,214 @@
+#include "../../include/TLB.h"
+#include "../../include/PageTable.h"
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// --- TLBLevel Implementation ---
+
+TLBLevel::TLBLevel(const std::string& nm, int num_entries, int assoc, ReplacementPolicy* repl,
+                   int page_sizes, int cycles)
+    : name(nm), num_sets(num_entries / assoc), ways(assoc), sizes(page_sizes), policy(repl),
+      latency(cycles) {
+    tags.assign(num_entries, 0);
+    valid.assign(num_entries, 0);
+    entries.assign(num_entries, nullptr);
+    kernels = &select_tag_kernels(ways);
+    policy->set_kernels(kernels);
+}
+
+TLBLevel::~TLBLevel() { delete policy; }
+
+PageTableEntry* TLBLevel::probe(unsigned long long page, bool huge, int asid) {
+    size_t set = page & (num_sets - 1);
+    size_t base = set * ways;
+    int way = kernels->find_way(&tags[base], &valid[base], ways, make_tag(page, huge, asid));
+    if (way == -1) return nullptr;
+    policy->on_hit(set, way);
+    return entries[base + way];
+}
+
+PageTableEntry* TLBLevel::lookup(unsigned long long vpn, int asid, bool count_miss) {
+    PageTableEntry* pte = nullptr;
+    if (sizes & TLB_BASE) pte = probe(vpn, false, asid);
+    if (!pte && (sizes & TLB_HUGE)) pte = probe(vpn >> PageTable::BITS_PER_LEVEL, true, asid);
+    if (pte) hits++;
+    else if (count_miss) misses++;
+    return pte;
+}
+
+void TLBLevel::insert(unsigned long long vpn, int asid, PageTableEntry* pte) {
+    unsigned long long page = pte->huge ? vpn >> PageTable::BITS_PER_LEVEL : vpn;
+    unsigned long long tag = make_tag(page, pte->huge, asid);
+    size_t set = page & (num_sets - 1);
+    size_t base = set * ways;
+    int way = kernels->find_way(&tags[base], &valid[base], ways, tag);
+    if (way == -1) {
+        way = kernels->find_invalid(&valid[base], ways);
+        if (way == -1) way = policy->victim(set);
+    }
+    tags[base + way] = tag;
+    valid[base + way] = 1;
+    entries[base + way] = pte;
+    policy->on_fill(set, way);
+}
+
+void TLBLevel::invalidate(unsigned long long vpn, bool huge, int asid) {
+    unsigned long long page = huge ? vpn >> PageTable::BITS_PER_LEVEL : vpn;
+    size_t base = (page & (num_sets - 1)) * ways;
+    int way = kernels->find_way(&tags[base], &valid[base], ways, make_tag(page, huge, asid));
+    if (way != -1) valid[base + way] = 0;
+}
+
+void TLBLevel::flush(int asid) {
+    for (size_t i = 0; i < tags.size(); i++) {
+        if (asid == -1 || (int)(tags[i] >> ASID_SHIFT) == asid) valid[i] = 0;
+    }
+}
+
+unsigned long long TLBLevel::reach(long long page_size) const {
+    unsigned long long bytes = 0;
+    for (size_t i = 0; i < tags.size(); i++) {
+        if (!valid[i]) continue;
+        bytes += (tags[i] & 1) ? (unsigned long long)page_size * PageTable::ENTRIES : page_size;
+    }
+    return bytes;
+}
+
+// Bytes in the largest unit (KB, MB, GB) that divides them exactly.
+static std::string format_bytes(unsigned long long bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB"};
+    int u = 0;
+    while (u < 3 && bytes >= 1024 && bytes % 1024 == 0) {
+        bytes /= 1024;
+        u++;
+    }
+    return std::to_string(bytes) + " " + units[u];
+}
+
+void TLBLevel::print_stats(long long page_size) const {
+    std::cout << std::left << std::setw(20) << (name + ":") << std::right
+              << "Hits: " << hits << ", Misses: " << misses;
+    if (hits + misses > 0) {
+        std::cout << ", Hit Rate: " << std::fixed << std::setprecision(2)
+                  << (double)hits / (hits + misses) * 100.0 << "%";
+    }
+    std::cout << " (" << num_sets * ways << " entries, " << ways << "-way";
+    if (sizes == TLB_HUGE) std::cout << ", huge pages";
+    else if (sizes == TLB_BOTH) std::cout << ", both sizes";
+    std::cout << ", reach " << format_bytes(reach(page_size)) << ")\n";
+}
+
+// --- TLB Implementation ---
+
+TLB::~TLB() {
+    delete dtlb;
+    delete dtlb_huge;
+    delete stlb;
+}
+
+TLBLevel* TLB::first_level(const PageTableEntry* pte) const {
+    return (pte->huge && dtlb_huge) ? dtlb_huge : dtlb;
+}
+
+PageTableEntry* TLB::lookup(unsigned long long vpn, int asid, long long& cycles) {
+    // The first-level arrays are probed in parallel
+    cycles += dtlb->get_latency();
+    PageTableEntry* pte = dtlb->lookup(vpn, asid, !dtlb_huge);
+    if (!pte && dtlb_huge) {
+        pte = dtlb_huge->lookup(vpn, asid, false);
+        if (!pte) {
+            dtlb->add_miss();
+            dtlb_huge->add_miss();
+        }
+    }
+    if (pte || !stlb) return pte;
+
+    cycles += stlb->get_latency();
+    pte = stlb->lookup(vpn, asid);
+    if (pte) first_level(pte)->insert(vpn, asid, pte); // Refill the level above
+    return pte;
+}
+
+void TLB::insert(unsigned long long vpn, int asid, PageTableEntry* pte) {
+    first_level(pte)->insert(vpn, asid, pte);
+    if (stlb) stlb->insert(vpn, asid, pte);
+}
+
+void TLB::invalidate(unsigned long long vpn, bool huge, int asid) {
+    for (TLBLevel* level : {dtlb, dtlb_huge, stlb}) {
+        if (level && level->holds(huge)) level->invalidate(vpn, huge, asid);
+    }
+}
+
+void TLB::flush(int asid) {
+    for (TLBLevel* level : {dtlb, dtlb_huge, stlb}) {
+        if (level) level->flush(asid);
+    }
+}
+
+bool TLB::set_latency(const std::string& level, int cycles) {
+    if (level == "dtlb") {
+        dtlb->set_latency(cycles);
+        if (dtlb_huge) dtlb_huge->set_latency(cycles);
+        return true;
+    }
+    if (level == "stlb" && stlb) {
+        stlb->set_latency(cycles);
+        return true;
+    }
+    return false;
+}
+
+void TLB::print_stats(long long page_size) const {
+    for (const TLBLevel* level : {dtlb, dtlb_huge, stlb}) {
+        if (level) level->print_stats(page_size);
+    }
+}
+
+// --- Factory ---
+
+static bool valid_geometry(const char* name, int entries, int ways) {
+    int sets = ways > 0 ? entries / ways : 0;
+    if (ways < 1 || ways > 64 || entries % ways != 0 || sets < 1 || (sets & (sets - 1)) != 0) {
+        std::cout << "Error: " << name << " needs 1-64 ways and a power-of-two set count "
+                  << "(entries / ways).\n";
+        return false;
+    }
+    return true;
+}
+
+static TLBLevel* create_tlb_level(const char* name, int entries, int ways, const std::string& policy,
+                                  int page_sizes, int cycles) {
+    if (!valid_geometry(name, entries, ways)) return nullptr;
+    ReplacementPolicy* repl = create_replacement_policy(policy, entries / ways, ways);
+    if (!repl) return nullptr;
+    return new TLBLevel(name, entries, ways, repl, page_sizes, cycles);
+}
+
+TLB* create_tlb(int l1_entries, int l1_ways, int l2_entries, int l2_ways,
+                const std::string& policy, int huge_entries, int huge_ways) {
+    TLBLevel* dtlb = create_tlb_level("DTLB", l1_entries, l1_ways, policy,
+                                      huge_entries > 0 ? TLB_BASE : TLB_BOTH, 1);
+    if (!dtlb) return nullptr;
+
+    TLBLevel* dtlb_huge = nullptr;
+    if (huge_entries > 0) {
+        dtlb_huge = create_tlb_level("DTLB (huge)", huge_entries, huge_ways, policy, TLB_HUGE, 1);
+        if (!dtlb_huge) {
+            delete dtlb;
+            return nullptr;
+        }
+    }
+
+    TLBLevel* stlb = nullptr;
+    if (l2_entries > 0) {
+        stlb = create_tlb_level("STLB", l2_entries, l2_ways, policy, TLB_BOTH, 7);
+        if (!stlb) {
+            delete dtlb;
+            delete dtlb_huge;
+            return nullptr;
+        }
+    }
+    return new TLB(dtlb, dtlb_huge, stlb);
+}
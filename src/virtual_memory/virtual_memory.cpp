@@ -1,50 +1,244 @@
 #include "../../include/VirtualMemory.h"
+#include <algorithm>
+#include <bitset>
 #include <iomanip>
 
-MMU::MMU(int pg_size, CacheController* c, MemorySimulator* sm) 
-    : page_size(pg_size), cache(c), std_mem(sm), timer(0) {
-    std::cout << "MMU Initialized with Page Size: " << page_size << " bytes\n";
+MMU::MMU(long long pg_size, CacheController* c, Allocator* sm) 
+    : page_size(pg_size), timer(0), asid_holder(MAX_ASIDS, -1), cache(c), std_mem(sm),
+      replacer(new LRUPageReplacer()) {
+    current = processes[add_process(0)].get();
+    asid_holder[0] = 0;
 }
 
-void MMU::access(int virtual_address, std::string type) {
+MMU::~MMU() {
+    delete tlb;
+    delete replacer;
+}
+
+void MMU::set_tlb(TLB* t) {
+    delete tlb;
+    tlb = t;
+}
+
+void MMU::set_page_replacer(PageReplacer* r) { rebuild_replacers(r, scope); }
+
+void MMU::set_replacement_scope(ReplacementScope s) {
+    if (s != scope) rebuild_replacers(create_page_replacer(replacer->name()), s);
+}
+
+void MMU::rebuild_replacers(PageReplacer* global, ReplacementScope s) {
+    struct Resident {
+        unsigned long long vpn;
+        PageTableEntry* pte;
+        int owner;
+    };
+    std::vector<Resident> pages;
+    auto collect = [&](unsigned long long vpn, PageTableEntry* pte, int owner) {
+        pages.push_back({vpn, pte, owner});
+    };
+    replacer->for_each(collect);
+    for (auto& p : processes) {
+        if (!p->replacer) continue;
+        p->replacer->for_each(collect);
+        delete p->replacer;
+        p->replacer = nullptr;
+    }
+    std::sort(pages.begin(), pages.end(), [](const Resident& a, const Resident& b) {
+        return a.pte->last_access_time < b.pte->last_access_time;
+    });
+
+    delete replacer;
+    replacer = global;
+    scope = s;
+    if (scope == SCOPE_LOCAL) {
+        for (auto& p : processes) p->replacer = create_page_replacer(replacer->name());
+    }
+    for (const Resident& page : pages) replacer_for(*processes[page.owner])->add(page.vpn, page.pte, page.owner);
+}
+
+int MMU::add_process(unsigned pid) {
+    int index = (int)processes.size();
+    processes.emplace_back(new Process(pid, index, PageTable::TABLE_REGION + index * PageTable::TABLE_SPAN));
+    if (scope == SCOPE_LOCAL) processes.back()->replacer = create_page_replacer(replacer->name());
+    process_index[pid] = index;
+    return index;
+}
+
+void MMU::switch_to(unsigned pid) {
+    context_switches++;
+    auto it = process_index.find(pid);
+    int index = (it != process_index.end()) ? it->second : add_process(pid);
+    current = processes[index].get();
+
+    // Without ASIDs the outgoing translations must go. With them, only an
+    // ASID recycled from another process (beyond MAX_ASIDS) needs a flush.
+    int& holder = asid_holder[current->asid];
+    if (!use_asids) {
+        if (tlb) tlb->flush();
+        tlb_flushes++;
+    } else if (holder != index && holder != -1) {
+        if (tlb) tlb->flush(current->asid);
+        tlb_flushes++;
+    }
+    holder = index;
+    if (verbose) std::cout << ">> Context Switch to PID " << pid << " (ASID " << current->asid << ")\n";
+}
+
+long long MMU::resident_pages() const {
+    long long total = 0;
+    for (const auto& p : processes) total += p->resident;
+    return total;
+}
+
+void MMU::access(unsigned long long virtual_address, bool is_write, bool is_ifetch,
+                 unsigned long long pc) {
     timer++;
+    accesses++;
+    current->accesses++;
+    PageTable& page_table = current->page_table;
     
-    // 1. Calculate VPN and Offset [cite: 96, 121]
-    int vpn = virtual_address / page_size;
-    int offset = virtual_address % page_size;
+    // 1. Calculate VPN [cite: 96, 121]
+    unsigned long long vpn = virtual_address / page_size;
 
-    // 2. Lookup in Page Table
-    if (!page_table[vpn].valid) {
-        std::cout << ">> Page Fault! VPN " << vpn << " not in memory.\n";
-        
-        // 3. Handle Page Fault (Bring data into Physical RAM) [cite: 108]
-        if (!handle_page_fault(vpn)) {
-            std::cout << "CRITICAL: Cannot resolve Page Fault. Memory Full?\n";
-            return;
+    if (!page_table.in_range(vpn)) {
+        if (verbose) std::cout << ">> Invalid Address: VA " << virtual_address
+                               << " is beyond the 4-level page table.\n";
+        return;
+    }
+
+    // 2. TLB first: a hit skips the page table entirely
+    long long cycles = 0;
+    PageTableEntry* pte = tlb ? tlb->lookup(vpn, current->asid, cycles) : nullptr;
+    tlb_cycles += cycles;
+    if (pte) {
+        if (verbose) std::cout << "   [TLB] Hit for VPN " << vpn << "\n";
+    } else {
+        // 3. Walk the Page Table (one read per level reached)
+        page_walks++;
+        unsigned long long refs[PageTable::LEVELS];
+        int n = 0;
+        pte = page_table.walk(vpn, refs, n);
+        long long walk = 0;
+        if (walk_to_cache && cache) {
+            for (int i = 0; i < n; i++) walk += cache->access_page_table(refs[i]);
+        } else {
+            walk = (long long)n * walk_latency;
+        }
+        walk_cycles += walk;
+        cycles += walk;
+
+        if (!pte || !pte->valid) {
+            page_faults++;
+            current->page_faults++;
+            if (verbose) std::cout << ">> Page Fault! VPN " << vpn << " not in memory.\n";
+
+            // Handle Page Fault (Bring data into Physical RAM) [cite: 108]
+            if (!handle_page_fault(vpn)) {
+                if (verbose) std::cout << "CRITICAL: Cannot resolve Page Fault. Memory Full?\n";
+                return;
+            }
+            fault_cycles += fault_latency;
+            cycles += fault_latency;
+            pte = page_table.find(vpn);
         }
+        // Tables are never freed, so the pointer stays valid
+        if (tlb) tlb->insert(vpn, current->asid, pte);
     }
 
-    // 4. Translation Success: Get Physical Address
-    int frame_addr = page_table[vpn].frame_start_addr;
-    int physical_address = frame_addr + offset;
+    // 4. Translation Success: Get Physical Address (the offset spans the
+    // whole frame for a huge page)
+    unsigned long long page_va = vpn * page_size;
+    if (pte->huge) {
+        unsigned long long sub = vpn & (PageTable::ENTRIES - 1);
+        page_va -= sub * page_size;
+        subpage_bits[pte->subpages][sub >> 6] |= 1ULL << (sub & 63);
+    }
+    unsigned long long physical_address = pte->frame_start_addr + (virtual_address - page_va);
     
-    // Update Page Metadata (LRU)
-    page_table[vpn].last_access_time = timer;
-    if (type == "write") page_table[vpn].dirty = true;
+    // Update Page Metadata (LRU, accessed and dirty bits)
+    pte->last_access_time = timer;
+    pte->referenced = true;
+    if (is_write) pte->dirty = true;
+    replacer_for(*current)->touch(pte);
 
-    std::cout << "   [MMU] VA " << virtual_address << " -> VPN " << vpn 
+    if (verbose) std::cout << "   [MMU] VA " << virtual_address << " -> VPN " << vpn 
               << " -> PA " << physical_address << "\n";
 
     // 5. Forward to Cache (Physical Address) [cite: 119]
+    long long data = memory_latency;
     if (cache) {
-        cache->access(physical_address, type);
-    } else {
+        data = cache->access(physical_address, is_write, is_ifetch, pc);
+    } else if (verbose) {
         std::cout << "   [MMU] Warning: No Cache connected. Access complete.\n";
     }
+    data_cycles += data;
+    latency.record(cycles + data);
 }
 
-bool MMU::handle_page_fault(int vpn) {
-    int allocated_addr = -1;
+bool MMU::add_huge_region(unsigned long long va, unsigned long long length) {
+    unsigned long long span = (unsigned long long)page_size * PageTable::ENTRIES;
+    unsigned long long first = (va + span - 1) / span * PageTable::ENTRIES;
+    unsigned long long last = (va + length) / span * PageTable::ENTRIES;
+    if (first >= last) return false;
+    current->huge_regions.push_back({first, last});
+    return true;
+}
+
+bool MMU::huge_eligible(unsigned long long vpn) const {
+    if (huge_mode == HUGE_NEVER) return false;
+    if (huge_mode == HUGE_MADVISE) {
+        bool inside = false;
+        for (const auto& region : current->huge_regions) {
+            if (vpn >= region.first && vpn < region.second) {
+                inside = true;
+                break;
+            }
+        }
+        if (!inside) return false;
+    }
+    // Base pages already mapped in the range keep it on base pages
+    return !current->page_table.has_base_pages(vpn);
+}
+
+bool MMU::map_huge_page(unsigned long long vpn) {
+    long long huge_size = page_size * PageTable::ENTRIES;
+    long long allocated_addr = std_mem ? std_mem->my_malloc(huge_size) : -1;
+    if (allocated_addr == -1) {
+        // No contiguous huge frame (full or fragmented memory)
+        huge_fallbacks++;
+        if (verbose) std::cout << ">> No free huge frame. Falling back to a base page.\n";
+        return false;
+    }
+
+    PageTableEntry& pte = current->page_table.map_huge(vpn);
+    pte.valid = true;
+    pte.frame_start_addr = allocated_addr;
+    pte.dirty = false;
+    pte.referenced = false;
+    pte.last_access_time = timer;
+    if (!free_subpage_bits.empty()) {
+        pte.subpages = free_subpage_bits.back();
+        free_subpage_bits.pop_back();
+    } else {
+        pte.subpages = (int)subpage_bits.size();
+        subpage_bits.emplace_back();
+    }
+    subpage_bits[pte.subpages].fill(0);
+
+    unsigned long long first_vpn = vpn & ~(unsigned long long)(PageTable::ENTRIES - 1);
+    replacer_for(*current)->add(first_vpn, &pte, current->index);
+    huge_faults++;
+    resident_huge++;
+    current->resident++;
+    current->resident_huge++;
+    if (verbose) std::cout << ">> Huge Page " << first_vpn << " loaded into Frame at " << allocated_addr << "\n";
+    return true;
+}
+
+bool MMU::handle_page_fault(unsigned long long vpn) {
+    if (huge_eligible(vpn) && map_huge_page(vpn)) return true;
+
+    long long allocated_addr = -1;
 
     // Try to allocate a new frame in Physical Memory
     if (std_mem) {
@@ -53,7 +247,7 @@ bool MMU::handle_page_fault(int vpn) {
 
     // If allocation failed (Memory Full), we need to EVICT a page [cite: 102, 106]
     if (allocated_addr == -1) {
-        std::cout << ">> Physical Memory Full. Evicting a victim page...\n";
+        if (verbose) std::cout << ">> Physical Memory Full. Evicting a victim page...\n";
         evict_victim();
         
         // Retry allocation
@@ -63,60 +257,185 @@ bool MMU::handle_page_fault(int vpn) {
     }
 
     // Update Page Table with new Frame
-    page_table[vpn].valid = true;
-    page_table[vpn].frame_start_addr = allocated_addr;
-    page_table[vpn].dirty = false;
-    page_table[vpn].last_access_time = timer;
+    PageTableEntry& pte = current->page_table.map(vpn);
+    pte.valid = true;
+    pte.frame_start_addr = allocated_addr;
+    pte.dirty = false;
+    pte.referenced = false;
+    pte.last_access_time = timer;
     
-    loaded_pages.push_back(vpn); // Track for replacement logic
-    std::cout << ">> Page " << vpn << " loaded into Frame at " << allocated_addr << "\n";
+    replacer_for(*current)->add(vpn, &pte, current->index); // Track for replacement logic
+    current->resident++;
+    if (verbose) std::cout << ">> Page " << vpn << " loaded into Frame at " << allocated_addr << "\n";
     
     return true;
 }
 
 void MMU::evict_victim() {
-    // Simple LRU Policy for Page Replacement
-    int victim_vpn = -1;
-    int min_time = 2147483647;
-    int victim_index = -1;
-
-    for (size_t i = 0; i < loaded_pages.size(); i++) {
-        int vpn = loaded_pages[i];
-        if (page_table[vpn].last_access_time < min_time) {
-            min_time = page_table[vpn].last_access_time;
-            victim_vpn = vpn;
-            victim_index = i;
+    // Victim chosen by the page replacement policy, among every process's
+    // pages or (local scope) the faulting process's own
+    PageReplacer* from = replacer;
+    if (scope == SCOPE_LOCAL) {
+        Process* target = current;
+        if (target->replacer->size() == 0) {
+            // Nothing of its own to give up yet: take from the largest
+            for (const auto& p : processes) {
+                if (p->replacer->size() > target->replacer->size()) target = p.get();
+            }
         }
+        from = target->replacer;
     }
 
-    if (victim_vpn != -1) {
+    unsigned long long victim_vpn;
+    PageTableEntry* pte;
+    int owner;
+    if (from->evict(victim_vpn, pte, owner)) {
+        PageTableEntry& victim = *pte;
+        Process& p = *processes[owner];
+        p.evictions++;
+        p.resident--;
+
         // Free the Physical Memory
-        int frame_addr = page_table[victim_vpn].frame_start_addr;
+        long long frame_addr = victim.frame_start_addr;
         if (std_mem) std_mem->my_free(frame_addr); 
         
-        // Update Page Table
-        page_table[victim_vpn].valid = false;
-        if (page_table[victim_vpn].dirty) {
-            std::cout << "   (Saving Dirty Page " << victim_vpn << " to disk...)\n";
+        // Update Page Table (and shoot down any cached translation)
+        victim.valid = false;
+        if (tlb) tlb->invalidate(victim_vpn, victim.huge, p.asid);
+        long long bytes = page_size;
+        if (victim.huge) {
+            bytes *= PageTable::ENTRIES;
+            free_subpage_bits.push_back(victim.subpages);
+            victim.subpages = -1;
+            resident_huge--;
+            p.resident_huge--;
+            huge_evictions++;
+        }
+        if (victim.dirty) {
+            dirty_writebacks++;
+            writeback_bytes += bytes;
+            if (verbose) std::cout << "   (Saving Dirty Page " << victim_vpn << " to disk...)\n";
         }
         
-        // Remove from loaded list
-        loaded_pages.erase(loaded_pages.begin() + victim_index);
-        std::cout << ">> Evicted Page " << victim_vpn << " (Frame " << frame_addr << " freed)\n";
+        evictions++;
+        if (verbose) std::cout << ">> Evicted Page " << victim_vpn << " (Frame " << frame_addr << " freed)\n";
     }
 }
 
 void MMU::print_page_table() {
     std::cout << "--- Page Table ---\n";
-    std::cout << "VPN   | Valid | Frame | Dirty | LRU Time\n";
-    for (auto const& [vpn, entry] : page_table) {
-        if (entry.valid) {
+    for (const auto& p : processes) {
+        if (processes.size() > 1) {
+            if (p->resident == 0) continue;
+            std::cout << "PID " << p->pid << " (ASID " << p->asid << "):\n";
+        }
+        std::cout << "VPN   | Valid | Frame | Dirty | LRU Time\n";
+        p->page_table.for_each_valid([](unsigned long long vpn, const PageTableEntry& entry) {
             std::cout << std::setw(5) << vpn << " | " 
                       << std::setw(5) << entry.valid << " | " 
                       << std::setw(5) << entry.frame_start_addr << " | " 
                       << std::setw(5) << entry.dirty << " | " 
-                      << std::setw(8) << entry.last_access_time << "\n";
-        }
+                      << std::setw(8) << entry.last_access_time
+                      << (entry.huge ? " (huge)" : "") << "\n";
+        });
     }
     std::cout << "------------------\n";
-}
\ No newline at end of file
+}
+
+void MMU::print_stats() {
+    std::cout << "--- MMU Statistics ---\n";
+    std::cout << "Page Size:          " << page_size << "\n";
+    std::cout << "Accesses:           " << accesses << "\n";
+    std::cout << "Page Faults:        " << page_faults;
+    if (accesses > 0) {
+        std::cout << " (" << std::fixed << std::setprecision(2)
+                  << (double)page_faults / accesses * 100.0 << "%)";
+    }
+    std::cout << "\n";
+    std::cout << "Evictions:          " << evictions << "\n";
+    std::cout << "Dirty Writebacks:   " << dirty_writebacks;
+    if (writeback_bytes > 0) std::cout << " (" << writeback_bytes << " bytes)";
+    std::cout << "\n";
+    std::cout << "Page Replacement:   " << replacer->name()
+              << (scope == SCOPE_LOCAL ? " (local scope)" : "") << "\n";
+    std::cout << "Resident Pages:     " << resident_pages() << "\n";
+    if (huge_mode != HUGE_NEVER || huge_faults > 0) {
+        static const char* const modes[] = {"never", "always", "madvise"};
+        long long touched = 0;
+        for (const auto& p : processes) {
+            p->page_table.for_each_valid([&](unsigned long long, const PageTableEntry& entry) {
+                if (!entry.huge) return;
+                for (uint64_t word : subpage_bits[entry.subpages]) touched += std::bitset<64>(word).count();
+            });
+        }
+        long long huge_base_pages = resident_huge * PageTable::ENTRIES;
+        std::cout << "Huge Pages:         " << modes[huge_mode] << ", " << huge_faults << " faults, "
+                  << huge_fallbacks << " fallbacks, " << huge_evictions << " evictions\n";
+        std::cout << "Resident Huge:      " << resident_huge << " (" << touched << " of "
+                  << huge_base_pages << " base pages touched";
+        if (huge_base_pages > 0) {
+            std::cout << ", " << std::fixed << std::setprecision(2)
+                      << (double)(huge_base_pages - touched) / huge_base_pages * 100.0 << "% bloat";
+        }
+        std::cout << ")\n";
+        std::cout << "Resident Memory:    "
+                  << (resident_pages() - resident_huge + huge_base_pages) * page_size << " bytes\n";
+    }
+    long long tables = 0;
+    long long refs[PageTable::LEVELS] = {0, 0, 0, 0};
+    for (const auto& p : processes) {
+        tables += p->page_table.get_tables();
+        for (int level = 0; level < PageTable::LEVELS; level++) refs[level] += p->page_table.get_refs(level);
+    }
+    std::cout << "Page Table Pages:   " << tables << "\n";
+    std::cout << "Walk References:   ";
+    for (int level = 0; level < PageTable::LEVELS; level++) {
+        std::cout << " " << PageTable::level_name(level) << " " << refs[level];
+    }
+    std::cout << "\n";
+    if (processes.size() > 1) print_processes();
+    if (tlb) {
+        std::cout << "Page Walks:         " << page_walks << "\n";
+        tlb->print_stats(page_size);
+    }
+    std::cout << "----------------------\n";
+}
+void MMU::print_processes() {
+    std::cout << "Context Switches:   " << context_switches << " (ASIDs " << (use_asids ? "on" : "off")
+              << ", " << tlb_flushes << " TLB flushes)\n";
+    size_t ran = 0;
+    for (const auto& p : processes) ran += (p->accesses > 0 || p->resident > 0);
+    std::cout << "Processes:          " << ran << "\n";
+    std::cout << "    PID  ASID    Accesses      Faults  Fault Rate   RSS (KB)   Evicted\n";
+    for (const auto& p : processes) {
+        if (p->accesses == 0 && p->resident == 0) continue; // Never ran (PID 0 in PID-tagged traces)
+        long long rss = (p->resident + p->resident_huge * (PageTable::ENTRIES - 1)) * page_size;
+        std::cout << std::setw(7) << p->pid << std::setw(6) << p->asid << std::setw(12) << p->accesses
+                  << std::setw(12) << p->page_faults << std::setw(11) << std::fixed << std::setprecision(2)
+                  << (p->accesses > 0 ? (double)p->page_faults / p->accesses * 100.0 : 0.0) << "%"
+                  << std::setw(11) << rss / 1024 << std::setw(10) << p->evictions << "\n";
+    }
+}
+
+void MMU::print_latency() {
+    std::cout << "--- Access Latency ---\n";
+    latency.print();
+    unsigned long long total = tlb_cycles + walk_cycles + fault_cycles + data_cycles;
+    auto row = [&](const char* label, unsigned long long cycles) {
+        std::cout << label << cycles << " cycles (" << std::fixed << std::setprecision(2)
+                  << (total ? (double)cycles / total * 100.0 : 0.0) << "%)";
+    };
+    if (tlb) {
+        row("TLB:                ", tlb_cycles);
+        std::cout << "\n";
+    }
+    row("Page Walks:         ", walk_cycles);
+    if (walk_to_cache && cache) std::cout << " [table reads through the cache]\n";
+    else std::cout << " [" << walk_latency << " per table read]\n";
+    row("Page Faults:        ", fault_cycles);
+    std::cout << " [" << fault_latency << " per fault]\n";
+    row(cache ? "Cache + Memory:     " : "Memory:             ", data_cycles);
+    std::cout << "\n";
+    std::cout << "----------------------\n";
+    if (cache) cache->print_latency(false);
+}